@@ -0,0 +1,44 @@
+#ifndef AO_H
+#define AO_H
+
+#include <vecmath.h>
+#include <string>
+#include <vector>
+
+// Settings for the ambient occlusion bake.
+struct AOParams
+{
+	// Number of hemisphere rays traced per vertex.
+	unsigned samples = 64;
+
+	// Rays longer than this don't count as occluded.  If zero, a
+	// quarter of the mesh bounding box diagonal is used.
+	float maxDistance = 0.0f;
+
+	// Number of worker threads.  Zero means one per hardware thread.
+	unsigned threads = 0;
+};
+
+// Bake per-vertex ambient occlusion for a triangle mesh.  positions
+// and normals are per vertex, indices holds three vertex indices per
+// triangle.  On return ao[i] is the unoccluded fraction of the
+// hemisphere above vertex i: 1 means fully open, 0 fully blocked.
+// The rays are cast against a BVH of the mesh on all cores, and
+// progress and rays/s are reported on cerr.
+void bakeAmbientOcclusion(const std::vector<Vector3f>& positions,
+	const std::vector<Vector3f>& normals,
+	const std::vector<unsigned>& indices,
+	std::vector<float>& ao,
+	const AOParams& params = AOParams());
+
+// Same as bakeAmbientOcclusion, but first looks for a previous bake
+// of the same mesh and parameters in cacheFile, and writes the result
+// there if it had to bake.  An empty cacheFile disables caching.
+void bakeAmbientOcclusionCached(const std::string& cacheFile,
+	const std::vector<Vector3f>& positions,
+	const std::vector<Vector3f>& normals,
+	const std::vector<unsigned>& indices,
+	std::vector<float>& ao,
+	const AOParams& params = AOParams());
+
+#endif
@@ -0,0 +1,481 @@
+#include "ao.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#ifndef M_PI
+#define M_PI  3.14159265358979
+#endif
+
+using namespace std;
+
+namespace
+{
+	// Triangles are stored as one vertex and two edges, which is what
+	// the Moller-Trumbore intersection test wants.
+	struct Triangle
+	{
+		Vector3f v0;
+		Vector3f e1;
+		Vector3f e2;
+	};
+
+	// Nodes are laid out depth first: the left child of an interior
+	// node always directly follows it, and "first" holds the index of
+	// the right child.  For leaves "first" is the first triangle and
+	// "count" the number of triangles.
+	struct BvhNode
+	{
+		Vector3f boxMin;
+		Vector3f boxMax;
+		unsigned first;
+		unsigned count;
+	};
+
+	const unsigned kLeafSize = 4;
+
+	// Bounding volume hierarchy over the triangles of a mesh.  Only
+	// supports "is anything hit" queries, which is all AO needs.
+	class Bvh
+	{
+	public:
+		Bvh(const vector<Vector3f>& positions, const vector<unsigned>& indices)
+		{
+			size_t triangleCount = indices.size() / 3;
+			vector<Triangle> triangles(triangleCount);
+			m_centroids.resize(triangleCount);
+			vector<unsigned> order(triangleCount);
+
+			for (size_t i = 0; i < triangleCount; ++i)
+			{
+				const Vector3f& a = positions[indices[3 * i + 0]];
+				const Vector3f& b = positions[indices[3 * i + 1]];
+				const Vector3f& c = positions[indices[3 * i + 2]];
+				triangles[i].v0 = a;
+				triangles[i].e1 = b - a;
+				triangles[i].e2 = c - a;
+				m_centroids[i] = (a + b + c) / 3.0f;
+				order[i] = i;
+			}
+
+			m_nodes.reserve(2 * triangleCount / kLeafSize + 1);
+			if (triangleCount > 0)
+				build(triangles, order, 0, triangleCount);
+
+			// Store the triangles in leaf order so a leaf is one contiguous run.
+			m_triangles.resize(triangleCount);
+			for (size_t i = 0; i < triangleCount; ++i)
+				m_triangles[i] = triangles[order[i]];
+
+			m_centroids.clear();
+			m_centroids.shrink_to_fit();
+		}
+
+		bool empty() const
+		{
+			return m_nodes.empty();
+		}
+
+		// Returns true if the ray origin + t * dir hits a triangle for
+		// some t in (0, tMax).
+		bool occluded(const Vector3f& origin, const Vector3f& dir, float tMax) const
+		{
+			Vector3f invDir;
+			for (int a = 0; a < 3; ++a)
+				invDir[a] = fabs(dir[a]) > 1e-12f ? 1.0f / dir[a] : (dir[a] < 0 ? -1e12f : 1e12f);
+
+			unsigned stack[64];
+			unsigned stackSize = 0;
+			unsigned nodeIndex = 0;
+
+			while (true)
+			{
+				const BvhNode& node = m_nodes[nodeIndex];
+
+				if (hitBox(node, origin, invDir, tMax))
+				{
+					if (node.count == 0)
+					{
+						stack[stackSize++] = node.first;
+						nodeIndex = nodeIndex + 1;
+						continue;
+					}
+
+					for (unsigned i = node.first; i < node.first + node.count; ++i)
+					{
+						if (hitTriangle(m_triangles[i], origin, dir, tMax))
+							return true;
+					}
+				}
+
+				if (stackSize == 0)
+					return false;
+
+				nodeIndex = stack[--stackSize];
+			}
+		}
+
+	private:
+		unsigned build(const vector<Triangle>& triangles, vector<unsigned>& order, unsigned first, unsigned count)
+		{
+			unsigned nodeIndex = m_nodes.size();
+			m_nodes.push_back(BvhNode());
+
+			Vector3f boxMin(FLT_MAX), boxMax(-FLT_MAX);
+			Vector3f centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+			for (unsigned i = first; i < first + count; ++i)
+			{
+				const Triangle& tri = triangles[order[i]];
+				Vector3f corners[3] = { tri.v0, tri.v0 + tri.e1, tri.v0 + tri.e2 };
+				for (int a = 0; a < 3; ++a)
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						boxMin[a] = min(boxMin[a], corners[k][a]);
+						boxMax[a] = max(boxMax[a], corners[k][a]);
+					}
+					centroidMin[a] = min(centroidMin[a], m_centroids[order[i]][a]);
+					centroidMax[a] = max(centroidMax[a], m_centroids[order[i]][a]);
+				}
+			}
+
+			m_nodes[nodeIndex].boxMin = boxMin;
+			m_nodes[nodeIndex].boxMax = boxMax;
+
+			// Split along the longest axis of the centroid bounds
+			Vector3f extent = centroidMax - centroidMin;
+			int axis = 0;
+			if (extent[1] > extent[axis]) axis = 1;
+			if (extent[2] > extent[axis]) axis = 2;
+
+			if (count <= kLeafSize || extent[axis] <= 0.0f)
+			{
+				m_nodes[nodeIndex].first = first;
+				m_nodes[nodeIndex].count = count;
+				return nodeIndex;
+			}
+
+			// Median split; keeps the tree balanced so the traversal stack stays shallow.
+			unsigned half = count / 2;
+			nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+				[this, axis](unsigned lhs, unsigned rhs) { return m_centroids[lhs][axis] < m_centroids[rhs][axis]; });
+
+			build(triangles, order, first, half);
+			unsigned right = build(triangles, order, first + half, count - half);
+
+			m_nodes[nodeIndex].first = right;
+			m_nodes[nodeIndex].count = 0;
+			return nodeIndex;
+		}
+
+		static bool hitBox(const BvhNode& node, const Vector3f& origin, const Vector3f& invDir, float tMax)
+		{
+			float tEnter = 0.0f;
+			float tExit = tMax;
+			for (int a = 0; a < 3; ++a)
+			{
+				float tNear = (node.boxMin[a] - origin[a]) * invDir[a];
+				float tFar = (node.boxMax[a] - origin[a]) * invDir[a];
+				if (tNear > tFar)
+					swap(tNear, tFar);
+				tEnter = max(tEnter, tNear);
+				tExit = min(tExit, tFar);
+				if (tEnter > tExit)
+					return false;
+			}
+			return true;
+		}
+
+		static bool hitTriangle(const Triangle& tri, const Vector3f& origin, const Vector3f& dir, float tMax)
+		{
+			Vector3f p = Vector3f::cross(dir, tri.e2);
+			float det = Vector3f::dot(tri.e1, p);
+			if (fabs(det) < 1e-12f)
+				return false;
+
+			float invDet = 1.0f / det;
+			Vector3f s = origin - tri.v0;
+			float u = Vector3f::dot(s, p) * invDet;
+			if (u < 0.0f || u > 1.0f)
+				return false;
+
+			Vector3f q = Vector3f::cross(s, tri.e1);
+			float v = Vector3f::dot(dir, q) * invDet;
+			if (v < 0.0f || u + v > 1.0f)
+				return false;
+
+			float t = Vector3f::dot(tri.e2, q) * invDet;
+			return t > 0.0f && t < tMax;
+		}
+
+		vector<BvhNode> m_nodes;
+		vector<Triangle> m_triangles;
+		vector<Vector3f> m_centroids; // only used while building
+	};
+
+	// Small deterministic random number generator.  It is seeded per
+	// vertex, so the bake gives the same result no matter how the
+	// vertices are split up between threads.
+	class Random
+	{
+	public:
+		explicit Random(uint32_t seed) : m_state(seed * 747796405u + 2891336453u) { }
+
+		float next()
+		{
+			m_state ^= m_state << 13;
+			m_state ^= m_state >> 17;
+			m_state ^= m_state << 5;
+			return (m_state >> 8) * (1.0f / 16777216.0f);
+		}
+
+	private:
+		uint32_t m_state;
+	};
+
+	// Builds an orthonormal basis (t, b, n) around the unit vector n
+	// (Duff et al., "Building an Orthonormal Basis, Revisited").
+	void makeBasis(const Vector3f& n, Vector3f& t, Vector3f& b)
+	{
+		float sign = n[2] >= 0.0f ? 1.0f : -1.0f;
+		float a = -1.0f / (sign + n[2]);
+		float c = n[0] * n[1] * a;
+		t = Vector3f(1.0f + sign * n[0] * n[0] * a, sign * c, -sign * n[0]);
+		b = Vector3f(c, sign + n[1] * n[1] * a, -n[1]);
+	}
+
+	float occlusionAt(const Bvh& bvh, const Vector3f& position, const Vector3f& normal,
+		unsigned vertex, unsigned samples, float maxDistance, float bias)
+	{
+		float length = normal.abs();
+		if (length == 0.0f)
+			return 1.0f;
+
+		Vector3f n = normal / length;
+		Vector3f t, b;
+		makeBasis(n, t, b);
+
+		Vector3f origin = position + n * bias;
+		Random random(vertex);
+
+		unsigned hits = 0;
+		for (unsigned s = 0; s < samples; ++s)
+		{
+			// Cosine-weighted direction, stratified in the polar angle
+			float u1 = (s + random.next()) / samples;
+			float u2 = random.next();
+			float r = sqrt(u1);
+			float phi = 2.0f * float(M_PI) * u2;
+			Vector3f dir = t * (r * cos(phi)) + b * (r * sin(phi)) + n * sqrt(max(0.0f, 1.0f - u1));
+
+			if (bvh.occluded(origin, dir, maxDistance))
+				++hits;
+		}
+
+		return 1.0f - float(hits) / samples;
+	}
+
+	// FNV-1a over the raw bytes of the bake inputs
+	void hashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	uint64_t hashInputs(const vector<Vector3f>& positions, const vector<Vector3f>& normals,
+		const vector<unsigned>& indices, const AOParams& params)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < positions.size(); ++i)
+			hashBytes(hash, static_cast<const float*>(positions[i]), 3 * sizeof(float));
+		for (size_t i = 0; i < normals.size(); ++i)
+			hashBytes(hash, static_cast<const float*>(normals[i]), 3 * sizeof(float));
+		if (!indices.empty())
+			hashBytes(hash, &indices[0], indices.size() * sizeof(unsigned));
+		hashBytes(hash, &params.samples, sizeof(params.samples));
+		hashBytes(hash, &params.maxDistance, sizeof(params.maxDistance));
+		return hash;
+	}
+
+	const char kCacheMagic[4] = { 'A', 'O', 'C', '1' };
+
+	bool loadCache(const string& filename, uint64_t key, size_t count, vector<float>& ao)
+	{
+		ifstream in(filename.c_str(), ios::binary);
+		if (!in)
+			return false;
+
+		char magic[4];
+		uint64_t fileKey;
+		uint64_t fileCount;
+		in.read(magic, sizeof(magic));
+		in.read(reinterpret_cast<char*>(&fileKey), sizeof(fileKey));
+		in.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
+		if (!in || memcmp(magic, kCacheMagic, sizeof(magic)) != 0 || fileKey != key || fileCount != count)
+			return false;
+
+		ao.resize(count);
+		if (count > 0)
+			in.read(reinterpret_cast<char*>(&ao[0]), count * sizeof(float));
+		return bool(in);
+	}
+
+	// Returns false if the file couldn't be opened or written.
+	bool saveCache(const string& filename, uint64_t key, const vector<float>& ao)
+	{
+		ofstream out(filename.c_str(), ios::binary);
+		if (!out)
+			return false;
+
+		uint64_t count = ao.size();
+		out.write(kCacheMagic, sizeof(kCacheMagic));
+		out.write(reinterpret_cast<const char*>(&key), sizeof(key));
+		out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		if (count > 0)
+			out.write(reinterpret_cast<const char*>(&ao[0]), count * sizeof(float));
+
+		// A full disk only shows up once the buffer is flushed
+		out.close();
+		return !out.fail();
+	}
+}
+
+void bakeAmbientOcclusion(const vector<Vector3f>& positions,
+	const vector<Vector3f>& normals,
+	const vector<unsigned>& indices,
+	vector<float>& ao,
+	const AOParams& params)
+{
+	const size_t vertexCount = positions.size();
+	ao.assign(vertexCount, 1.0f);
+	if (vertexCount == 0 || params.samples == 0)
+		return;
+
+	typedef chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+
+	Bvh bvh(positions, indices);
+	if (bvh.empty())
+		return;
+
+	// Scale dependent distances come from the mesh bounds
+	Vector3f boxMin(FLT_MAX), boxMax(-FLT_MAX);
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		for (int a = 0; a < 3; ++a)
+		{
+			boxMin[a] = min(boxMin[a], positions[i][a]);
+			boxMax[a] = max(boxMax[a], positions[i][a]);
+		}
+	}
+	float diagonal = (boxMax - boxMin).abs();
+	float maxDistance = params.maxDistance > 0.0f ? params.maxDistance : 0.25f * diagonal;
+	float bias = 1e-4f * diagonal;
+
+	double buildSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+	unsigned threadCount = params.threads;
+	if (threadCount == 0)
+		threadCount = max(1u, thread::hardware_concurrency());
+
+	// Workers grab chunks of vertices until none are left
+	const size_t chunk = 64;
+	atomic<size_t> next(0);
+	atomic<size_t> done(0);
+	mutex progressMutex;
+	condition_variable progress;
+
+	auto worker = [&]()
+	{
+		while (true)
+		{
+			size_t begin = next.fetch_add(chunk);
+			if (begin >= vertexCount)
+				break;
+
+			size_t end = min(vertexCount, begin + chunk);
+			for (size_t i = begin; i < end; ++i)
+				ao[i] = occlusionAt(bvh, positions[i], normals[i], unsigned(i), params.samples, maxDistance, bias);
+
+			if ((done += end - begin) == vertexCount)
+			{
+				// wake the progress loop at once rather than at its next tick
+				lock_guard<mutex> lock(progressMutex);
+				progress.notify_all();
+			}
+		}
+	};
+
+	Clock::time_point traceStart = Clock::now();
+
+	vector<thread> workers;
+	for (unsigned i = 0; i < threadCount; ++i)
+		workers.push_back(thread(worker));
+
+	// Report progress every 250 ms while the workers run.  The wait
+	// ends as soon as the last vertex is done, so a quick bake doesn't
+	// pay for a whole tick.
+	unique_lock<mutex> lock(progressMutex);
+	while (!progress.wait_for(lock, chrono::milliseconds(250), [&]() { return done == vertexCount; }))
+	{
+		size_t finished = done;
+		double seconds = chrono::duration<double>(Clock::now() - traceStart).count();
+		double raysPerSecond = seconds > 0.0 ? finished * double(params.samples) / seconds : 0.0;
+		cerr << "\r  ao: " << (100 * finished / vertexCount) << "% ("
+			<< raysPerSecond * 1e-6 << " Mrays/s)   " << flush;
+	}
+
+	lock.unlock();
+
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+
+	double traceSeconds = chrono::duration<double>(Clock::now() - traceStart).count();
+	double rays = double(vertexCount) * params.samples;
+
+	cerr << "\r  ao: " << vertexCount << " vertices, " << indices.size() / 3 << " triangles, "
+		<< rays << " rays on " << threadCount << " threads in " << traceSeconds << " s ("
+		<< (traceSeconds > 0.0 ? rays / traceSeconds * 1e-6 : 0.0) << " Mrays/s, bvh "
+		<< buildSeconds * 1e3 << " ms)" << endl;
+}
+
+void bakeAmbientOcclusionCached(const string& cacheFile,
+	const vector<Vector3f>& positions,
+	const vector<Vector3f>& normals,
+	const vector<unsigned>& indices,
+	vector<float>& ao,
+	const AOParams& params)
+{
+	if (cacheFile.empty())
+	{
+		bakeAmbientOcclusion(positions, normals, indices, ao, params);
+		return;
+	}
+
+	uint64_t key = hashInputs(positions, normals, indices, params);
+	if (loadCache(cacheFile, key, positions.size(), ao))
+	{
+		cerr << "  ao: loaded " << cacheFile << endl;
+		return;
+	}
+
+	bakeAmbientOcclusion(positions, normals, indices, ao, params);
+	if (saveCache(cacheFile, key, ao))
+		cerr << "  ao: wrote " << cacheFile << endl;
+	else
+		cerr << "  ao: could not write cache " << cacheFile << endl;
+}
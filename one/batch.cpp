@@ -0,0 +1,319 @@
+// Headless batch tessellation of SWP files.  Nothing here touches
+// OpenGL: the files are parsed, their curves and surfaces evaluated
+// and the meshes written on a thread pool, and the time spent in each
+// stage is reported at the end.
+//
+// usage: batch [-j THREADS] [-f obj|ply|plyascii] [-o OUTDIR] [-n] [-v] SWPFILE...
+//
+//   -j  number of worker threads, one per hardware thread by default
+//   -f  output format, obj by default
+//   -o  directory for the meshes; by default they go next to the
+//       SWP file, named like the OBJPREFIX output of main
+//   -n  don't write any meshes
+//   -v  print the parser log of every file
+//
+// Every stage runs one task per item (file, curve, surface or mesh)
+// and ends before the next begins.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <vecmath.h>
+
+#include "parse.h"
+#include "surf.h"
+#include "threadpool.h"
+
+using namespace std;
+
+namespace
+{
+	typedef chrono::steady_clock Clock;
+
+	double secondsSince(Clock::time_point start)
+	{
+		return chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Everything known about one SWP file.
+	struct Job
+	{
+		Job() : ok(false) {}
+
+		string path;
+		bool ok;
+		string log;
+		vector<SwpObject> objects;
+		vector<Curve> curves;
+		vector<Surface> surfaces;
+	};
+
+	// Timing of a stage: wall time, and the sum of the time spent in
+	// its tasks, which is more than the wall time when they overlap.
+	struct Stage
+	{
+		Stage(const char* name) : name(name), tasks(0), taskNanoseconds(0), wall(0) {}
+
+		const char* name;
+		atomic<size_t> tasks;
+		atomic<int64_t> taskNanoseconds;
+		double wall;
+	};
+
+	// Submits one task per item and waits for all of them.
+	template <typename Body>
+	void runStage(ThreadPool& pool, Stage& stage, size_t count, const Body& body)
+	{
+		Clock::time_point start = Clock::now();
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			pool.submit([&stage, &body, i]()
+			{
+				Clock::time_point taskStart = Clock::now();
+				body(i);
+				stage.taskNanoseconds += chrono::duration_cast<chrono::nanoseconds>(Clock::now() - taskStart).count();
+				++stage.tasks;
+			});
+		}
+
+		pool.wait();
+		stage.wall = secondsSince(start);
+	}
+
+	void reportStage(const Stage& stage)
+	{
+		cerr << setw(14) << stage.name
+			<< setw(8) << stage.tasks
+			<< setw(12) << stage.wall * 1e3
+			<< setw(12) << stage.taskNanoseconds * 1e-6 << endl;
+	}
+
+	// The file name of the SWP file without directory and extension.
+	string baseName(const string& path)
+	{
+		string::size_type slash = path.find_last_of("/\\");
+		string name = (slash == string::npos) ? path : path.substr(slash + 1);
+
+		string::size_type dot = name.rfind('.');
+		return (dot == string::npos || dot == 0) ? name : name.substr(0, dot);
+	}
+
+	// Like baseName, but keeping the directory.
+	string stripExtension(const string& path)
+	{
+		string::size_type slash = path.find_last_of("/\\");
+		string::size_type dot = path.rfind('.');
+		if (dot == string::npos || (slash != string::npos && dot < slash))
+			return path;
+		return path.substr(0, dot);
+	}
+
+	void usage(const char* program)
+	{
+		cerr << "usage: " << program << " [-j THREADS] [-f obj|ply|plyascii] [-o OUTDIR] [-n] [-v] SWPFILE..." << endl;
+		exit(0);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned threads = 0;
+	string format = "obj";
+	string outDir;
+	bool write = true;
+	bool verbose = false;
+	vector<Job> jobs;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg(argv[i]);
+
+		if ((arg == "-j" || arg == "-f" || arg == "-o") && i + 1 >= argc)
+			usage(argv[0]);
+
+		if (arg == "-j")
+			threads = atoi(argv[++i]);
+		else if (arg == "-f")
+			format = argv[++i];
+		else if (arg == "-o")
+			outDir = argv[++i];
+		else if (arg == "-n")
+			write = false;
+		else if (arg == "-v")
+			verbose = true;
+		else if (arg[0] == '-')
+			usage(argv[0]);
+		else
+		{
+			jobs.push_back(Job());
+			jobs.back().path = arg;
+		}
+	}
+
+	if (jobs.empty() || (format != "obj" && format != "ply" && format != "plyascii"))
+		usage(argv[0]);
+
+	ThreadPool pool(threads);
+	cerr << "*** " << jobs.size() << " files on " << pool.size() << " threads ***" << endl;
+
+	Stage parse("parse");
+	Stage curveEval("curve eval");
+	Stage surfaceBuild("surface build");
+	Stage writeMeshes("write");
+
+	runStage(pool, parse, jobs.size(), [&](size_t i)
+	{
+		Job& job = jobs[i];
+		ostringstream log;
+
+		ifstream in(job.path.c_str());
+		if (!in)
+			log << job.path << " not found" << endl;
+		else
+			job.ok = readSwpObjects(in, job.objects, log);
+
+		job.log = log.str();
+	});
+
+	// Flatten the curves and surfaces of all the files that parsed
+	vector< pair<Job*, const SwpObject*> > curves, surfaces;
+	bool failed = false;
+
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		Job& job = jobs[i];
+
+		if (verbose || !job.ok)
+			cerr << "--- " << job.path << endl << job.log;
+
+		if (!job.ok)
+		{
+			cerr << job.path << ": error in file format, skipping" << endl;
+			failed = true;
+			continue;
+		}
+
+		size_t curveCount = 0, surfaceCount = 0;
+		for (size_t j = 0; j < job.objects.size(); ++j)
+		{
+			const SwpObject& object = job.objects[j];
+			if (object.isCurve())
+			{
+				curves.push_back(make_pair(&job, &object));
+				++curveCount;
+			}
+			else
+			{
+				surfaces.push_back(make_pair(&job, &object));
+				++surfaceCount;
+			}
+		}
+
+		job.curves.resize(curveCount);
+		job.surfaces.resize(surfaceCount);
+	}
+
+	// Every evaluation logs to its own buffer; with -v the buffers go
+	// to cerr in order once the stage is over.
+	vector<string> curveLogs(curves.size()), surfaceLogs(surfaces.size());
+
+	runStage(pool, curveEval, curves.size(), [&](size_t i)
+	{
+		Job& job = *curves[i].first;
+		const SwpObject& curve = *curves[i].second;
+		ostringstream log;
+		job.curves[curve.index] = evalSwpCurve(curve, log);
+		curveLogs[i] = log.str();
+	});
+
+	runStage(pool, surfaceBuild, surfaces.size(), [&](size_t i)
+	{
+		Job& job = *surfaces[i].first;
+		const SwpObject& surface = *surfaces[i].second;
+		ostringstream log;
+		job.surfaces[surface.index] = makeSwpSurface(surface, job.objects, job.curves, log);
+		surfaceLogs[i] = log.str();
+	});
+
+	if (verbose)
+	{
+		for (size_t i = 0; i < curveLogs.size(); ++i)
+			cerr << curveLogs[i];
+		for (size_t i = 0; i < surfaceLogs.size(); ++i)
+			cerr << surfaceLogs[i];
+	}
+
+	// Named surfaces are written, as in main
+	vector< pair<Job*, const SwpObject*> > meshes;
+	if (write)
+	{
+		for (size_t i = 0; i < surfaces.size(); ++i)
+			if (surfaces[i].second->name != ".")
+				meshes.push_back(surfaces[i]);
+	}
+
+	atomic<int64_t> bytesWritten(0);
+
+	runStage(pool, writeMeshes, meshes.size(), [&](size_t i)
+	{
+		Job& job = *meshes[i].first;
+		const SwpObject& surface = *meshes[i].second;
+
+		string prefix = outDir.empty()
+			? stripExtension(job.path)
+			: outDir + "/" + baseName(job.path);
+		string filename = prefix + "_" + surface.name + (format == "obj" ? ".obj" : ".ply");
+
+		ofstream out(filename.c_str(), format == "ply" ? ios::binary : ios::out);
+		if (!out)
+		{
+			cerr << "could not open file " << filename << ", skipping" << endl;
+			return;
+		}
+
+		if (format == "obj")
+			outputObjFile(out, job.surfaces[surface.index]);
+		else
+			outputPlyFile(out, job.surfaces[surface.index], format == "ply");
+
+		bytesWritten += int64_t(out.tellp());
+	});
+
+	// Surfaces on the same grid share their faces
+	size_t triangles = 0, storedTriangles = 0;
+	set<const Tup3u*> faceArrays;
+	for (size_t i = 0; i < jobs.size(); ++i)
+		for (size_t j = 0; j < jobs[i].surfaces.size(); ++j)
+		{
+			const SharedFaces& faces = jobs[i].surfaces[j].VF;
+			triangles += faces.size();
+			if (faceArrays.insert(faces.data()).second)
+				storedTriangles += faces.size();
+		}
+
+	cerr << endl << setw(14) << "stage" << setw(8) << "tasks"
+		<< setw(12) << "wall ms" << setw(12) << "task ms" << endl;
+	cerr << fixed << setprecision(2);
+	reportStage(parse);
+	reportStage(curveEval);
+	reportStage(surfaceBuild);
+	reportStage(writeMeshes);
+
+	double total = parse.wall + curveEval.wall + surfaceBuild.wall + writeMeshes.wall;
+	double megabytes = bytesWritten / (1024.0 * 1024.0);
+	cerr << setw(14) << "total" << setw(8) << "" << setw(12) << total * 1e3 << endl << endl;
+	cerr << triangles << " triangles (" << storedTriangles << " stored), " << megabytes << " MB written ("
+		<< megabytes / max(writeMeshes.wall, 1e-9) << " MB/s)" << endl;
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+// Benchmarks for the curve and surface code of assignment one.  The
+// vecmath kernels have their own, in vecmath/bench.
+//
+// usage: bench [MAXMB]
+//
+// MAXMB caps the memory of a single benchmark case in megabytes;
+// larger cases are skipped.  It defaults to 8192 on 64-bit builds and
+// 1024 on 32-bit builds, where the largest sweeps can't be allocated.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <vecmath.h>
+
+#include "curve.h"
+#include "surf.h"
+
+using namespace std;
+
+namespace
+{
+	typedef chrono::steady_clock Clock;
+
+	double secondsSince(Clock::time_point start)
+	{
+		return chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Memory of a surface with the given grid size: position and
+	// normal per vertex, two triangles per cell.
+	double surfaceMegabytes(double profileSize, double rings)
+	{
+		double vertices = profileSize * rings;
+		double triangles = 2.0 * (profileSize - 1) * (rings - 1);
+		return (vertices * 2 * sizeof(Vector3f) + triangles * sizeof(Tup3u)) / (1024.0 * 1024.0);
+	}
+
+	// Runs build() until at least 0.2 s have passed and returns the
+	// average time per call.  vertices is set to the vertex count of
+	// the built surface, which is smaller than the grid when the seams
+	// are welded.
+	template <typename Build>
+	double timeBuild(const Build& build, double& vertices)
+	{
+		unsigned runs = 0;
+		Clock::time_point start = Clock::now();
+		do
+		{
+			Surface surface = build();
+			vertices = double(surface.VV.size());
+			++runs;
+		} while (secondsSince(start) < 0.2);
+
+		return secondsSince(start) / runs;
+	}
+
+	template <typename Build>
+	double timeBuild(const Build& build)
+	{
+		double vertices;
+		return timeBuild(build, vertices);
+	}
+
+	// makeSurfRev and makeGenCyl over a sweep of profile sizes and
+	// sweep steps, up to 10k samples x 10k steps.
+	void benchSweptSurfaces(double maxMegabytes)
+	{
+		const unsigned sizes[] = { 100, 1000, 10000 };
+
+		cout << "swept surfaces" << endl;
+		cout << setw(10) << "profile" << setw(10) << "steps"
+			<< setw(14) << "surfRev ms" << setw(14) << "Mverts/s"
+			<< setw(14) << "genCyl ms" << setw(14) << "Mverts/s" << endl;
+
+		for (unsigned p = 0; p < 3; ++p)
+		{
+			// evalCircle gives steps + 1 points, flat on the xy plane
+			Curve profile = evalCircle(0.25f, sizes[p] - 1);
+
+			for (unsigned s = 0; s < 3; ++s)
+			{
+				unsigned steps = sizes[s];
+				cout << setw(10) << profile.size() << setw(10) << steps;
+
+				if (surfaceMegabytes(profile.size(), steps + 1) > maxMegabytes)
+				{
+					cout << "   skipped (" << surfaceMegabytes(profile.size(), steps + 1) << " MB)" << endl;
+					continue;
+				}
+
+				Curve sweep = evalCircle(2.0f, steps);
+				double surfRevVertices, genCylVertices;
+				double surfRev = timeBuild([&]() { return makeSurfRev(profile, steps); }, surfRevVertices);
+				double genCyl = timeBuild([&]() { return makeGenCyl(profile, sweep); }, genCylVertices);
+
+				cout << fixed << setprecision(2)
+					<< setw(14) << surfRev * 1e3 << setw(14) << surfRevVertices / surfRev * 1e-6
+					<< setw(14) << genCyl * 1e3 << setw(14) << genCylVertices / genCyl * 1e-6
+					<< defaultfloat << endl;
+			}
+		}
+	}
+
+	// Moving one control point of a dense B-spline sweep: patching the
+	// curve and the generalized cylinder in place with EditableBspline
+	// and updateGenCylSweep, against evaluating and building both from
+	// scratch.  Points are moved from the middle of the sweep to the
+	// end, where fewer frames follow.
+	void benchEditing()
+	{
+		const unsigned controlPoints = 1000;
+		const unsigned steps = 10;
+
+		vector<Vector3f> P(controlPoints);
+		for (unsigned i = 0; i < controlPoints; ++i)
+			P[i] = Vector3f(0.1f * i, sin(0.05f * i), cos(0.07f * i));
+
+		Curve profile = evalCircle(0.25f, 99);
+		EditableBspline sweep(P, steps);
+		Surface surface = makeGenCyl(profile, sweep.curve());
+
+		cout << endl << "control point edits (" << controlPoints << " cps x " << steps
+			<< " steps sweep, " << profile.size() << " point profile)" << endl;
+		cout << setw(10) << "point" << setw(14) << "local ms" << setw(14) << "full ms" << endl;
+
+		const unsigned moved[] = { controlPoints / 2, 3 * controlPoints / 4, controlPoints - 2 };
+		for (unsigned m = 0; m < 3; ++m)
+		{
+			unsigned i = moved[m];
+			Vector3f p = P[i] + Vector3f(0, 0.1f, 0);
+
+			Clock::time_point start = Clock::now();
+			CurveChange change = sweep.setControlPoint(i, p);
+			updateGenCylSweep(surface, profile, sweep.curve(), change);
+			double local = secondsSince(start);
+
+			P[i] = p;
+			double full = timeBuild([&]() { return makeGenCyl(profile, evalBspline(P, steps)); });
+
+			cout << fixed << setprecision(3)
+				<< setw(10) << i << setw(14) << local * 1e3 << setw(14) << full * 1e3
+				<< defaultfloat << endl;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	double maxMegabytes = sizeof(void*) >= 8 ? 8192 : 1024;
+	if (argc > 1)
+		maxMegabytes = atof(argv[1]);
+
+	benchSweptSurfaces(maxMegabytes);
+	benchEditing();
+
+	return 0;
+}
@@ -0,0 +1,360 @@
+#ifndef _WIN32
+#define GL_GLEXT_PROTOTYPES
+#endif
+
+#include "buffers.h"
+
+#ifdef _WIN32
+#include <GL/freeglut.h>
+#else
+#include <GL/glext.h>
+#endif
+
+#include <map>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER         0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW          0x88E4
+#endif
+
+namespace
+{
+	typedef void (APIENTRY *GenBuffersProc)(GLsizei n, GLuint* buffers);
+	typedef void (APIENTRY *DeleteBuffersProc)(GLsizei n, const GLuint* buffers);
+	typedef void (APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+	typedef void (APIENTRY *BufferDataProc)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+
+	GenBuffersProc genBuffers = 0;
+	DeleteBuffersProc deleteBuffers = 0;
+	BindBufferProc bindBuffer = 0;
+	BufferDataProc bufferData = 0;
+
+	// A surface vertex as it is stored in the vertex buffer
+	struct SurfaceVertex
+	{
+		float position[3];
+		float normal[3];
+	};
+
+	// A vertex of the normal and frame line segments
+	struct LineVertex
+	{
+		float position[3];
+		GLubyte color[4];
+	};
+
+	void setVertex(LineVertex& vertex, const Vector3f& position, GLubyte r, GLubyte g, GLubyte b)
+	{
+		for (int k = 0; k < 3; ++k)
+			vertex.position[k] = position[k];
+		vertex.color[0] = r;
+		vertex.color[1] = g;
+		vertex.color[2] = b;
+		vertex.color[3] = 255;
+	}
+
+	// Creates a buffer with a copy of count values at data and adds its
+	// size to bytes.
+	template <typename T>
+	GLuint createBuffer(GLenum target, const T* data, size_t count, size_t& bytes)
+	{
+		GLuint buffer = 0;
+		if (count == 0)
+			return buffer;
+
+		genBuffers(1, &buffer);
+		bindBuffer(target, buffer);
+		bufferData(target, count * sizeof(T), data, GL_STATIC_DRAW);
+		bindBuffer(target, 0);
+
+		bytes += count * sizeof(T);
+		return buffer;
+	}
+
+	template <typename T>
+	GLuint createBuffer(GLenum target, const vector<T>& data, size_t& bytes)
+	{
+		return createBuffer(target, data.data(), data.size(), bytes);
+	}
+
+	// A face array is uploaded as it is, as three GLuint indices per
+	// face (tuple.h checks there is nothing in between).
+	static_assert(is_same<Tup3u, ::tuple<GLuint, 3> >::value, "faces must hold GLuint indices");
+
+	// One element buffer per face array, shared by the surfaces that
+	// share the faces (see SharedFaces).  The entry holds on to the
+	// faces, so the array can't be freed and its address reused while
+	// the buffer exists.
+	struct SharedElementBuffer
+	{
+		SharedFaces faces;
+		GLuint buffer;
+		unsigned users;
+		size_t bytes;
+	};
+
+	map<const Tup3u*, SharedElementBuffer> elementBuffers;
+
+	GLuint acquireElementBuffer(const SharedFaces& faces)
+	{
+		if (faces.empty())
+			return 0;
+
+		SharedElementBuffer& shared = elementBuffers[faces.data()];
+		if (shared.users++ > 0)
+			return shared.buffer;
+
+		shared.faces = faces;
+		shared.bytes = 0;
+		shared.buffer = createBuffer(GL_ELEMENT_ARRAY_BUFFER, faces.data(), faces.size(), shared.bytes);
+		return shared.buffer;
+	}
+
+	void releaseElementBuffer(GLuint buffer)
+	{
+		for (map<const Tup3u*, SharedElementBuffer>::iterator it = elementBuffers.begin(); it != elementBuffers.end(); ++it)
+		{
+			if (it->second.buffer != buffer)
+				continue;
+
+			if (--it->second.users == 0)
+			{
+				deleteBuffers(1, &buffer);
+				elementBuffers.erase(it);
+			}
+			return;
+		}
+	}
+
+	void drawLines(const MeshBuffers& buffers)
+	{
+		if (!buffers.lines)
+			return;
+
+		glPushAttrib(GL_ALL_ATTRIB_BITS);
+		glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+		glDisable(GL_LIGHTING);
+		glLineWidth(1);
+
+		bindBuffer(GL_ARRAY_BUFFER, buffers.lines);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(3, GL_FLOAT, sizeof(LineVertex), (const void*)offsetof(LineVertex, position));
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(LineVertex), (const void*)offsetof(LineVertex, color));
+		glDrawArrays(GL_LINES, 0, buffers.lineVertexCount);
+		bindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glPopClientAttrib();
+		glPopAttrib();
+	}
+}
+
+bool loadBufferFunctions()
+{
+#ifdef _WIN32
+	genBuffers = (GenBuffersProc)glutGetProcAddress("glGenBuffers");
+	deleteBuffers = (DeleteBuffersProc)glutGetProcAddress("glDeleteBuffers");
+	bindBuffer = (BindBufferProc)glutGetProcAddress("glBindBuffer");
+	bufferData = (BufferDataProc)glutGetProcAddress("glBufferData");
+#else
+	genBuffers = glGenBuffers;
+	deleteBuffers = glDeleteBuffers;
+	bindBuffer = glBindBuffer;
+	bufferData = (BufferDataProc)glBufferData;
+#endif
+
+	return genBuffers && deleteBuffers && bindBuffer && bufferData;
+}
+
+void uploadSurface(MeshBuffers& buffers, const Surface& surface, float normalLength)
+{
+	deleteMeshBuffers(buffers);
+
+	vector<SurfaceVertex> vertices(surface.VV.size());
+	for (unsigned i = 0; i < surface.VV.size(); i++)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			vertices[i].position[k] = surface.VV[i][k];
+			vertices[i].normal[k] = surface.VN[i][k];
+		}
+	}
+
+	buffers.vertices = createBuffer(GL_ARRAY_BUFFER, vertices, buffers.bytes);
+	buffers.indices = acquireElementBuffer(surface.VF);
+	buffers.vertexCount = GLsizei(vertices.size());
+	buffers.indexCount = GLsizei(3 * surface.VF.size());
+
+	// AO darkens the current material color per vertex
+	if (surface.AO.size() == surface.VV.size())
+	{
+		GLfloat diffuse[4];
+		glGetMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
+
+		vector<GLubyte> colors(4 * surface.AO.size());
+		for (unsigned i = 0; i < surface.AO.size(); i++)
+		{
+			for (int k = 0; k < 3; ++k)
+				colors[4 * i + k] = GLubyte(255.0f * diffuse[k] * surface.AO[i] + 0.5f);
+			colors[4 * i + 3] = GLubyte(255.0f * diffuse[3] + 0.5f);
+		}
+
+		buffers.colors = createBuffer(GL_ARRAY_BUFFER, colors, buffers.bytes);
+	}
+
+	vector<LineVertex> lines(2 * surface.VV.size());
+	for (unsigned i = 0; i < surface.VV.size(); i++)
+	{
+		setVertex(lines[2 * i], surface.VV[i], 0, 255, 255);
+		setVertex(lines[2 * i + 1], surface.VV[i] + surface.VN[i] * normalLength, 0, 255, 255);
+	}
+
+	buffers.lines = createBuffer(GL_ARRAY_BUFFER, lines, buffers.bytes);
+	buffers.lineVertexCount = GLsizei(lines.size());
+}
+
+void uploadCurve(MeshBuffers& buffers, const Curve& curve, float frameSize)
+{
+	deleteMeshBuffers(buffers);
+
+	vector<Vector3f> vertices(curve.size());
+	for (unsigned i = 0; i < curve.size(); ++i)
+		vertices[i] = curve[i].V;
+
+	buffers.vertices = createBuffer(GL_ARRAY_BUFFER, vertices, buffers.bytes);
+	buffers.vertexCount = GLsizei(vertices.size());
+
+	// Three segments per point, along N (red), B (green) and T (blue)
+	vector<LineVertex> lines(6 * curve.size());
+	for (unsigned i = 0; i < curve.size(); ++i)
+	{
+		const CurvePoint& pt = curve[i];
+		LineVertex* frame = &lines[6 * i];
+		setVertex(frame[0], pt.V, 255, 0, 0);
+		setVertex(frame[1], pt.V + pt.N * frameSize, 255, 0, 0);
+		setVertex(frame[2], pt.V, 0, 255, 0);
+		setVertex(frame[3], pt.V + pt.B * frameSize, 0, 255, 0);
+		setVertex(frame[4], pt.V, 0, 0, 255);
+		setVertex(frame[5], pt.V + pt.T * frameSize, 0, 0, 255);
+	}
+
+	buffers.lines = createBuffer(GL_ARRAY_BUFFER, lines, buffers.bytes);
+	buffers.lineVertexCount = GLsizei(lines.size());
+}
+
+void deleteMeshBuffers(MeshBuffers& buffers)
+{
+	GLuint names[] = { buffers.vertices, buffers.colors, buffers.lines };
+	for (int i = 0; i < 3; ++i)
+		if (names[i])
+			deleteBuffers(1, &names[i]);
+
+	if (buffers.indices)
+		releaseElementBuffer(buffers.indices);
+
+	buffers = MeshBuffers();
+}
+
+size_t sharedBufferBytes()
+{
+	size_t bytes = 0;
+	for (map<const Tup3u*, SharedElementBuffer>::const_iterator it = elementBuffers.begin(); it != elementBuffers.end(); ++it)
+		bytes += it->second.bytes;
+	return bytes;
+}
+
+unsigned sharedBufferCount()
+{
+	return unsigned(elementBuffers.size());
+}
+
+void drawSurfaceBuffers(const MeshBuffers& buffers, bool shaded, bool occlusion)
+{
+	if (!buffers.vertices || !buffers.indices)
+		return;
+
+	// Save current state of OpenGL
+	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+	bindBuffer(GL_ARRAY_BUFFER, buffers.vertices);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(SurfaceVertex), (const void*)offsetof(SurfaceVertex, position));
+
+	if (shaded)
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, sizeof(SurfaceVertex), (const void*)offsetof(SurfaceVertex, normal));
+
+		if (occlusion && buffers.colors)
+		{
+			bindBuffer(GL_ARRAY_BUFFER, buffers.colors);
+			glEnableClientState(GL_COLOR_ARRAY);
+			glColorPointer(4, GL_UNSIGNED_BYTE, 0, 0);
+			glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+			glEnable(GL_COLOR_MATERIAL);
+		}
+
+		// Culling back faces also shows whether the triangles are
+		// wound the right way
+		glEnable(GL_LIGHTING);
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		glEnable(GL_CULL_FACE);
+		glCullFace(GL_BACK);
+	}
+	else
+	{
+		glDisable(GL_LIGHTING);
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+		glColor4f(0.4f, 0.4f, 0.4f, 1.f);
+		glLineWidth(1);
+	}
+
+	bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.indices);
+	glDrawElements(GL_TRIANGLES, buffers.indexCount, GL_UNSIGNED_INT, 0);
+
+	bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	bindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glPopClientAttrib();
+	glPopAttrib();
+}
+
+void drawNormalBuffers(const MeshBuffers& buffers)
+{
+	drawLines(buffers);
+}
+
+void drawCurveBuffers(const MeshBuffers& buffers, bool frames)
+{
+	if (!buffers.vertices)
+		return;
+
+	// Save current state of OpenGL
+	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+	// Setup for line drawing
+	glDisable(GL_LIGHTING);
+	glColor4f(1, 1, 1, 1);
+	glLineWidth(1);
+
+	bindBuffer(GL_ARRAY_BUFFER, buffers.vertices);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(Vector3f), 0);
+	glDrawArrays(GL_LINE_STRIP, 0, buffers.vertexCount);
+	bindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glPopClientAttrib();
+	glPopAttrib();
+
+	if (frames)
+		drawLines(buffers);
+}
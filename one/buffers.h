@@ -0,0 +1,70 @@
+#ifndef BUFFERS_H
+#define BUFFERS_H
+
+#include "surf.h"
+#include "extra.h"
+
+#include <cstddef>
+
+// The GPU copy of one curve or surface.  A surface is uploaded once as
+// an interleaved position/normal vertex buffer plus an index buffer
+// holding VF, and the shaded, AO and wireframe modes all draw from
+// those.  Surfaces sharing their faces also share the index buffer.
+// A curve is a buffer of positions drawn as a line strip.  The line
+// segments of the normals (surfaces) and coordinate frames (curves)
+// go in a second buffer with a color per vertex.
+struct MeshBuffers
+{
+    MeshBuffers()
+        : vertices(0), indices(0), colors(0), lines(0),
+          vertexCount(0), indexCount(0), lineVertexCount(0), bytes(0)
+    {
+    }
+
+    GLuint vertices;
+    GLuint indices;
+    GLuint colors;      // surfaces with baked AO: material color times AO
+    GLuint lines;
+
+    GLsizei vertexCount;
+    GLsizei indexCount;
+    GLsizei lineVertexCount;
+
+    // GPU memory taken by the buffers, except the shared index buffer
+    size_t bytes;
+};
+
+// Buffer objects are OpenGL 1.5.  This gets hold of the functions
+// (through glutGetProcAddress where the GL library only exports 1.1,
+// as on Windows) and has to be called once a context exists.  Returns
+// false if the driver doesn't support them.
+bool loadBufferFunctions();
+
+// Upload a surface, with normals of length normalLength.  If the
+// surface has baked AO, it is stored as per-vertex colors: the current
+// material's diffuse color darkened by the occlusion.
+void uploadSurface( MeshBuffers& buffers, const Surface& surface, float normalLength );
+
+// Upload a curve, with frames of size frameSize.
+void uploadCurve( MeshBuffers& buffers, const Curve& curve, float frameSize );
+
+void deleteMeshBuffers( MeshBuffers& buffers );
+
+// GPU memory and number of the shared index buffers
+size_t sharedBufferBytes();
+unsigned sharedBufferCount();
+
+// Draws the surface with smooth shading, using the current material
+// and lights, if shaded==true, otherwise as a gray wireframe.  Back
+// faces are culled when shaded.  If occlusion==true and the surface
+// has AO colors, they replace the material color.
+void drawSurfaceBuffers( const MeshBuffers& buffers, bool shaded, bool occlusion = false );
+
+// Draws the normals of a surface as cyan lines.
+void drawNormalBuffers( const MeshBuffers& buffers );
+
+// Draws the curve as a white line strip and, if frames==true, its
+// coordinate frames with N, B and T in red, green and blue.
+void drawCurveBuffers( const MeshBuffers& buffers, bool frames );
+
+#endif
@@ -1,9 +1,10 @@
 #include "curve.h"
-#include "extra.h"
-#ifdef WIN32
-#include <windows.h>
-#endif
-#include <GL/gl.h>
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
 using namespace std;
 
 namespace
@@ -16,55 +17,141 @@ namespace
 		return (lhs - rhs).absSquared() < eps;
 	}
 
+	const Matrix4f BSplineBasis(
+		1.0f / 6.0f, -3.0f / 6.0f, 3.0f / 6.0f, -1.0f / 6.0f,
+		4.0f / 6.0f, 0.0f, -6.0f / 6.0f, 3.0f / 6.0f,
+		1.0f / 6.0f, 3.0f / 6.0f, 3.0f / 6.0f, -3.0f / 6.0f,
+		0.0f, 0.0f, 0.0f, 1.0f / 6.0f);
 
-}
+	const Matrix4f BezierBasis(
+		1.0f, -3.0f, 3.0f, -1.0f,
+		0.0f, 3.0f, -6.0f, 3.0f,
+		0.0f, 0.0f, 3.0f, -3.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	);
 
-const Matrix4f BSplineBasis(
-	1.0f / 6.0f, -3.0f / 6.0f, 3.0f / 6.0f, -1.0f / 6.0f,
-	4.0f / 6.0f, 0.0f, -6.0f / 6.0f, 3.0f / 6.0f,
-	1.0f / 6.0f, 3.0f / 6.0f, 3.0f / 6.0f, -3.0f / 6.0f,
-	0.0f, 0.0f, 0.0f, 1.0f / 6.0f);
+	enum BasisType
+	{
+		BEZIER,
+		BSPLINE
+	};
+
+	// Row k of a basis matrix holds the coefficients of 1, t, t^2, t^3 in
+	// the weight of control point k.  This evaluates the four weights and
+	// their derivatives at t.
+	void evaluateBasis(const Matrix4f& basis, float t, float* weights, float* derivatives)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			weights[k] = basis(k, 0) + t * (basis(k, 1) + t * (basis(k, 2) + t * basis(k, 3)));
+			derivatives[k] = basis(k, 1) + t * (2 * basis(k, 2) + t * 3 * basis(k, 3));
+		}
+	}
 
-const Matrix4f BezierBasis(
-	1.0f, -3.0f, 3.0f, -1.0f,
-	0.0f, 3.0f, -6.0f, 3.0f,
-	0.0f, 0.0f, 3.0f, -3.0f,
-	0.0f, 0.0f, 0.0f, 1.0f
-);
+	// The weights of the four control points of a cubic piece sampled at
+	// t = i / steps, i = 0..steps.  They only depend on the basis and the
+	// number of steps, so they are computed once and shared by every
+	// piece of every curve.  W and D store 4 floats per sample.
+	struct BasisTable
+	{
+		unsigned steps;
+		vector<float> W; // position weights
+		vector<float> D; // derivative weights
+	};
 
-const Matrix4f BezierBasisInversed = BezierBasis.inverse();
+	const BasisTable& getBasisTable(BasisType type, unsigned steps)
+	{
+		static map<pair<BasisType, unsigned>, unique_ptr<BasisTable> > tables;
+		static mutex tablesMutex;
 
-const Matrix4f BSplineBasisByBezierBasisInversed = BSplineBasis * BezierBasisInversed;
+		lock_guard<mutex> lock(tablesMutex);
 
-Vector3f getAnyNormalTo(Vector3f vec)
-{
-	static const Vector3f basisVectors[] = { -Vector3f::FORWARD,Vector3f::UP ,Vector3f::RIGHT , };
+		unique_ptr<BasisTable>& table = tables[make_pair(type, steps)];
+		if (!table)
+		{
+			table.reset(new BasisTable);
+			table->steps = steps;
+			table->W.resize(4 * (steps + 1));
+			table->D.resize(4 * (steps + 1));
+
+			const Matrix4f& basis = type == BEZIER ? BezierBasis : BSplineBasis;
+			for (unsigned i = 0; i <= steps; ++i)
+				evaluateBasis(basis, static_cast<float>(i) / steps, &table->W[4 * i], &table->D[4 * i]);
+		}
 
-	Vector3f crossProduct;
-	int i = 0;
-	do
+		return *table;
+	}
+
+	// Control points split into separate x, y and z arrays, so a piece is
+	// four consecutive floats in each.
+	struct ControlPointsSoA
 	{
-		crossProduct = Vector3f::cross(vec, basisVectors[i++]);
-	} while (Vector3f::dot(crossProduct, crossProduct) < 1E-9f);
+		explicit ControlPointsSoA(const vector<Vector3f>& P) : x(P.size()), y(P.size()), z(P.size())
+		{
+			for (size_t i = 0; i < P.size(); ++i)
+			{
+				x[i] = P[i][0];
+				y[i] = P[i][1];
+				z[i] = P[i][2];
+			}
+		}
 
-	return crossProduct.normalized();
-}
+		vector<float> x;
+		vector<float> y;
+		vector<float> z;
+	};
 
+	Vector3f getAnyNormalTo(Vector3f vec)
+	{
+		static const Vector3f basisVectors[] = { -Vector3f::FORWARD,Vector3f::UP ,Vector3f::RIGHT , };
 
-void populateBezierCurveSegment(Curve& result, const vector<Vector3f>& P, int start_index, unsigned steps)
-{
-	for (unsigned curve_pt_index = start_index, i = 0; curve_pt_index <= start_index + steps; ++curve_pt_index, ++i)
+		Vector3f crossProduct;
+		int i = 0;
+		do
+		{
+			crossProduct = Vector3f::cross(vec, basisVectors[i++]);
+		} while (Vector3f::dot(crossProduct, crossProduct) < 1E-9f);
+
+		return crossProduct.normalized();
+	}
+
+
+	// Evaluates the vertices and tangents of the cubic piece whose
+	// control points start at first_cp into result[start_index ..
+	// start_index + steps).  This is the (steps+1)x4 basis table times the
+	// 4x3 block of control points.  The point at t = 1 is shared with the
+	// next piece, so it is only written for the last piece of a curve
+	// (last == true).  Pieces write disjoint ranges and can therefore be
+	// evaluated concurrently.
+	void populateCurveSegment(Curve& result, const BasisTable& basis, const ControlPointsSoA& P, unsigned first_cp, unsigned start_index, bool last)
 	{
-		float t = static_cast<float>(i) / steps;
-		float one_minus_t = (1 - t);
-		result[curve_pt_index].V =
-			P[0] * one_minus_t * one_minus_t * one_minus_t
-			+ P[1] * 3 * t * one_minus_t * one_minus_t
-			+ P[2] * 3 * t * t * one_minus_t
-			+ P[3] * t * t * t;
+		const float* x = &P.x[first_cp];
+		const float* y = &P.y[first_cp];
+		const float* z = &P.z[first_cp];
 
-		result[curve_pt_index].T = (-3 * (P[0] * one_minus_t * one_minus_t + P[1] * (-3 * t * t + 4 * t - 1) + t * (3 * P[2] * t - 2 * P[2] - P[3] * t))).normalized();
+		unsigned count = last ? basis.steps + 1 : basis.steps;
+		for (unsigned i = 0; i < count; ++i)
+		{
+			const float* w = &basis.W[4 * i];
+			const float* d = &basis.D[4 * i];
+			CurvePoint& pt = result[start_index + i];
+
+			pt.V = Vector3f(
+				w[0] * x[0] + w[1] * x[1] + w[2] * x[2] + w[3] * x[3],
+				w[0] * y[0] + w[1] * y[1] + w[2] * y[2] + w[3] * y[3],
+				w[0] * z[0] + w[1] * z[1] + w[2] * z[2] + w[3] * z[3]);
+
+			pt.T = Vector3f(
+				d[0] * x[0] + d[1] * x[1] + d[2] * x[2] + d[3] * x[3],
+				d[0] * y[0] + d[1] * y[1] + d[2] * y[2] + d[3] * y[3],
+				d[0] * z[0] + d[1] * z[1] + d[2] * z[2] + d[3] * z[3]).normalized();
+		}
+	}
 
+	// Computes the normal and binormal of point i from its tangent and
+	// the binormal of point i - 1.
+	void computeCurveFrame(Curve& result, unsigned curve_pt_index)
+	{
 		if (curve_pt_index == 0)
 		{
 			//first normal is taken arbitrary
@@ -73,63 +160,450 @@ void populateBezierCurveSegment(Curve& result, const vector<Vector3f>& P, int st
 		else
 		{
 			//use previous binormal to get next normal
-			result[curve_pt_index].N = Vector3f::cross(result[curve_pt_index - 1].B, result[curve_pt_index].T);
+			result[curve_pt_index].N = Vector3f::cross(result[curve_pt_index - 1].B, result[curve_pt_index].T).normalized();
 		}
 
 		result[curve_pt_index].B = Vector3f::cross(result[curve_pt_index].T, result[curve_pt_index].N).normalized();
 	}
+
+	// Fills in the normals and binormals once all vertices and tangents
+	// are known.  Each frame is propagated from the previous one, so this
+	// runs serially over the whole curve; that keeps the frames identical
+	// no matter how the pieces were evaluated.
+	void computeCurveFrames(Curve& result)
+	{
+		for (unsigned curve_pt_index = 0; curve_pt_index < result.size(); ++curve_pt_index)
+			computeCurveFrame(result, curve_pt_index);
+	}
+
+	// Pieces are only spread over threads when each thread gets at least
+	// this many curve points to evaluate.
+	const unsigned kParallelCurvePoints = 4096;
+
+	void checkBezierControlPoints(const vector< Vector3f >& P)
+	{
+		if (P.size() < 4 || P.size() % 3 != 1)
+		{
+			cerr << "evalBezier must be called with 3n+1 control points." << endl;
+			exit(0);
+		}
+	}
+
+	void checkBsplineControlPoints(const vector< Vector3f >& P)
+	{
+		if (P.size() < 4)
+		{
+			cerr << "evalBspline must be called with 4 or more control points." << endl;
+			exit(0);
+		}
+	}
+
+	// One cubic piece, evaluated at arbitrary t for adaptive sampling.
+	struct CurvePiece
+	{
+		CurvePiece(const Matrix4f& basis, const Vector3f* P) : basis(basis), P(P) { }
+
+		void eval(float t, Vector3f& V, Vector3f& D) const
+		{
+			float w[4], d[4];
+			evaluateBasis(basis, t, w, d);
+			V = P[0] * w[0] + P[1] * w[1] + P[2] * w[2] + P[3] * w[3];
+			D = P[0] * d[0] + P[1] * d[1] + P[2] * d[2] + P[3] * d[3];
+		}
+
+		const Matrix4f& basis;
+		const Vector3f* P;
+	};
+
+	// Intervals are never split more than this many times, which bounds a
+	// piece at 1024 samples however tight the tolerance is.
+	const unsigned kMaxAdaptiveDepth = 10;
+
+	float distanceToSegment(const Vector3f& p, const Vector3f& a, const Vector3f& b)
+	{
+		Vector3f ab = b - a;
+		float lengthSquared = ab.absSquared();
+		float s = lengthSquared > 0.0f ? Vector3f::dot(p - a, ab) / lengthSquared : 0.0f;
+		s = min(1.0f, max(0.0f, s));
+		return (p - (a + ab * s)).abs();
+	}
+
+	// True if the piece between t0 and t1 is close enough to the straight
+	// line between its end points.  The chord test looks at the quarter
+	// points too, so an S-bend whose midpoint lies on the chord still
+	// gets split.
+	bool flatEnough(const CurvePiece& piece, float t0, const Vector3f& p0, const Vector3f& d0,
+		float t1, const Vector3f& p1, const Vector3f& d1, const CurveTolerance& tolerance)
+	{
+		if (tolerance.angle > 0.0f)
+		{
+			float lengths = d0.abs() * d1.abs();
+			if (lengths > 0.0f)
+			{
+				float cosAngle = min(1.0f, max(-1.0f, Vector3f::dot(d0, d1) / lengths));
+				if (acos(cosAngle) > tolerance.angle * float(M_PI) / 180.0f)
+					return false;
+			}
+		}
+
+		if (tolerance.chord > 0.0f)
+		{
+			for (int k = 1; k < 4; ++k)
+			{
+				Vector3f p, d;
+				piece.eval(t0 + (t1 - t0) * k / 4, p, d);
+				if (distanceToSegment(p, p0, p1) > tolerance.chord)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Appends the end parameters of the sub-intervals of [t0, t1] that
+	// meet the tolerance.
+	void subdivide(const CurvePiece& piece, float t0, const Vector3f& p0, const Vector3f& d0,
+		float t1, const Vector3f& p1, const Vector3f& d1,
+		const CurveTolerance& tolerance, unsigned depth, vector<float>& params)
+	{
+		if (depth < kMaxAdaptiveDepth && !flatEnough(piece, t0, p0, d0, t1, p1, d1, tolerance))
+		{
+			float tm = 0.5f * (t0 + t1);
+			Vector3f pm, dm;
+			piece.eval(tm, pm, dm);
+			subdivide(piece, t0, p0, d0, tm, pm, dm, tolerance, depth + 1, params);
+			subdivide(piece, tm, pm, dm, t1, p1, d1, tolerance, depth + 1, params);
+		}
+		else
+		{
+			params.push_back(t1);
+		}
+	}
+
+	// Adaptive counterpart of the fixed-step evaluation: every piece is
+	// subdivided on its own (in parallel), then the pieces are laid out
+	// one after the other and the frames are propagated as usual.
+	Curve evalAdaptive(BasisType type, const vector< Vector3f >& P, unsigned segment_number, unsigned cp_stride, const CurveTolerance& tolerance)
+	{
+		const Matrix4f& basis = type == BEZIER ? BezierBasis : BSplineBasis;
+
+		// params[i] holds the parameters in (0, 1] sampled on piece i,
+		// always ending with 1.  Every piece is split at least once.
+		vector< vector<float> > params(segment_number);
+		parallelFor(0, segment_number, 16, [&](size_t i)
+		{
+			CurvePiece piece(basis, &P[cp_stride * i]);
+			Vector3f p0, d0, pm, dm, p1, d1;
+			piece.eval(0.0f, p0, d0);
+			piece.eval(0.5f, pm, dm);
+			piece.eval(1.0f, p1, d1);
+			subdivide(piece, 0.0f, p0, d0, 0.5f, pm, dm, tolerance, 1, params[i]);
+			subdivide(piece, 0.5f, pm, dm, 1.0f, p1, d1, tolerance, 1, params[i]);
+		});
+
+		// Piece i starts at its t = 0 point; the t = 1 point is the start of
+		// the next piece, except for the last one.
+		vector<unsigned> start(segment_number + 1, 0);
+		for (unsigned i = 0; i < segment_number; ++i)
+			start[i + 1] = start[i] + params[i].size();
+
+		Curve result(start[segment_number] + 1);
+
+		parallelFor(0, segment_number, 16, [&](size_t i)
+		{
+			CurvePiece piece(basis, &P[cp_stride * i]);
+			bool last = i + 1 == segment_number;
+			unsigned count = last ? params[i].size() + 1 : params[i].size();
+			for (unsigned k = 0; k < count; ++k)
+			{
+				CurvePoint& pt = result[start[i] + k];
+				Vector3f derivative;
+				piece.eval(k == 0 ? 0.0f : params[i][k - 1], pt.V, derivative);
+				pt.T = derivative.normalized();
+			}
+		});
+
+		computeCurveFrames(result);
+
+		return result;
+	}
+
+	// Samples per piece of the dense curve that evenly spaced curves
+	// measure their arc length on.
+	const unsigned kArcLengthTableSteps = 64;
+
+	// Evenly spaced counterpart of the fixed-step evaluation.  The curve is
+	// first evaluated densely to build its arc-length table, then every
+	// sample is placed at its share of the length and the curve evaluated
+	// there.
+	Curve evalArcLength(BasisType type, const vector< Vector3f >& P, unsigned segment_number, unsigned cp_stride, unsigned steps)
+	{
+		const Matrix4f& basis = type == BEZIER ? BezierBasis : BSplineBasis;
+		ControlPointsSoA cps(P);
+
+		unsigned dense_steps = max(kArcLengthTableSteps, 4 * steps);
+		const BasisTable& dense_basis = getBasisTable(type, dense_steps);
+		Curve dense(dense_steps * segment_number + 1);
+
+		parallelFor(0, segment_number, kParallelCurvePoints / dense_steps, [&](size_t i)
+		{
+			populateCurveSegment(dense, dense_basis, cps, cp_stride * i, i * dense_steps, i + 1 == segment_number);
+		});
+
+		ArcLengthTable table(dense);
+		Curve result(steps * segment_number + 1);
+		// With steps == 0 the result is just the start point
+		float spacing = result.size() > 1 ? table.length() / (result.size() - 1) : 0.0f;
+
+		parallelFor(0, result.size(), kParallelCurvePoints, [&](size_t k)
+		{
+			// Global parameter: piece index plus t within the piece
+			float u = table.indexAt(spacing * k) / dense_steps;
+			unsigned piece = min(unsigned(u), segment_number - 1);
+
+			Vector3f derivative;
+			CurvePiece(basis, &P[cp_stride * piece]).eval(u - piece, result[k].V, derivative);
+			result[k].T = derivative.normalized();
+		});
+
+		computeCurveFrames(result);
+
+		return result;
+	}
 }
 
-Curve evalBezier(const vector< Vector3f >& P, unsigned steps)
+Curve evalBezier(const vector< Vector3f >& P, unsigned steps, CurveSpacing spacing)
 {
-	// Check
-	if (P.size() < 4 || P.size() % 3 != 1)
+	checkBezierControlPoints(P);
+
+	unsigned segment_number = (P.size() - 1) / 3;
+	if (spacing == ARC_LENGTH_SPACING)
+		return evalArcLength(BEZIER, P, segment_number, 3, steps);
+
+	Curve result(steps * segment_number + 1);
+
+	const BasisTable& basis = getBasisTable(BEZIER, steps);
+	ControlPointsSoA cps(P);
+
+	parallelFor(0, segment_number, kParallelCurvePoints / max(steps, 1u), [&](size_t i)
 	{
-		cerr << "evalBezier must be called with 3n+1 control points." << endl;
-		exit(0);
-	}
+		populateCurveSegment(result, basis, cps, 3 * i, i * steps, i + 1 == segment_number);
+	});
+
+	computeCurveFrames(result);
+
+	return result;
+}
 
-	Curve result(steps + 1);
+Curve evalBspline(const vector< Vector3f >& P, unsigned steps, CurveSpacing spacing)
+{
+	checkBsplineControlPoints(P);
+
+	unsigned cubic_segment_number = P.size() - 3;
+	if (spacing == ARC_LENGTH_SPACING)
+		return evalArcLength(BSPLINE, P, cubic_segment_number, 1, steps);
+
+	Curve result(steps * cubic_segment_number + 1);
+
+	const BasisTable& basis = getBasisTable(BSPLINE, steps);
+	ControlPointsSoA cps(P);
 
-	populateBezierCurveSegment(result, P, 0, steps);
+	parallelFor(0, cubic_segment_number, kParallelCurvePoints / max(steps, 1u), [&](size_t i)
+	{
+		populateCurveSegment(result, basis, cps, i, i * steps, i + 1 == cubic_segment_number);
+	});
+
+	computeCurveFrames(result);
 
 	return result;
 }
 
-Curve evalBspline(const vector< Vector3f >& P, unsigned steps)
+bool closedCurve(const Curve& curve)
+{
+	if (curve.size() < 4)
+		return false;
+
+	const CurvePoint& first = curve.front();
+	const CurvePoint& last = curve.back();
+	return sameCurveVector(first.V, last.V) && sameCurveVector(first.T, last.T);
+}
+
+bool sameCurveVector(const Vector3f& a, const Vector3f& b)
 {
-	// Check
-	if (P.size() < 4)
+	const float tolerance = 1e-5f;
+	float scale = max(1.0f, max(a.abs(), b.abs()));
+	return (a - b).abs() <= tolerance * scale;
+}
+
+void computeRotationMinimizingFrames(Curve& curve)
+{
+	if (curve.empty())
+		return;
+
+	// The first normal is arbitrary, as for the propagated frames
+	computeCurveFrame(curve, 0);
+
+	// Each step reflects the frame in the plane bisecting the chord to
+	// the next point, then in the plane that takes the reflected
+	// tangent to the next tangent.  Reflections keep the normal a unit
+	// vector, so nothing is normalized along the way; the binormal is
+	// the cross product of the unit tangent and normal, which are
+	// perpendicular, so it is a unit vector as well.
+	for (size_t i = 0; i + 1 < curve.size(); ++i)
 	{
-		cerr << "evalBspline must be called with 4 or more control points." << endl;
-		exit(0);
+		const CurvePoint& pt = curve[i];
+		CurvePoint& next = curve[i + 1];
+
+		Vector3f v1 = next.V - pt.V;
+		float c1 = Vector3f::dot(v1, v1);
+
+		Vector3f r = pt.N;
+		Vector3f t = pt.T;
+		if (c1 > 0.0f)
+		{
+			r = r - v1 * (2.0f / c1 * Vector3f::dot(v1, r));
+			t = t - v1 * (2.0f / c1 * Vector3f::dot(v1, t));
+		}
+
+		Vector3f v2 = next.T - t;
+		float c2 = Vector3f::dot(v2, v2);
+		if (c2 > 0.0f)
+			r = r - v2 * (2.0f / c2 * Vector3f::dot(v2, r));
+
+		next.N = r;
+		next.B = Vector3f::cross(next.T, r);
 	}
 
-	auto cubic_segment_number = P.size() - 3;
-	Curve result(steps * cubic_segment_number + 1);
+	if (!closedCurve(curve))
+		return;
+
+	// The angle about the tangent from the last normal to the first one
+	const CurvePoint& first = curve.front();
+	const CurvePoint& last = curve.back();
+	float twist = atan2(Vector3f::dot(first.T, Vector3f::cross(last.N, first.N)), Vector3f::dot(last.N, first.N));
 
-	for (size_t i = 0; i < cubic_segment_number; ++i)
+	ArcLengthTable lengths(curve);
+	float length = lengths.length();
+	if (length <= 0.0f)
+		return;
+
+	for (size_t i = 1; i + 1 < curve.size(); ++i)
 	{
-		vector<Vector3f> P_b_spl_seg = { P[i],P[i + 1], P[i + 2], P[i + 3] };
-		Matrix4f P_b_spl_seg_matrix(
-			P_b_spl_seg[0].x(), P_b_spl_seg[1].x(), P_b_spl_seg[2].x(), P_b_spl_seg[3].x(),
-			P_b_spl_seg[0].y(), P_b_spl_seg[1].y(), P_b_spl_seg[2].y(), P_b_spl_seg[3].y(),
-			P_b_spl_seg[0].z(), P_b_spl_seg[1].z(), P_b_spl_seg[2].z(), P_b_spl_seg[3].z(),
-			0.0f, 0.0f, 0.0f, 0.0f);
+		float angle = twist * lengths.lengthAt(unsigned(i)) / length;
+		float c = cos(angle), s = sin(angle);
 
-		Matrix4f P_bezier_matrix = P_b_spl_seg_matrix * BSplineBasisByBezierBasisInversed;
-		vector<Vector3f> P_bezier =
-		{
-			Vector3f(P_bezier_matrix(0,0),P_bezier_matrix(1,0),P_bezier_matrix(2,0)),
-			Vector3f(P_bezier_matrix(0,1),P_bezier_matrix(1,1),P_bezier_matrix(2,1)),
-			Vector3f(P_bezier_matrix(0,2),P_bezier_matrix(1,2),P_bezier_matrix(2,2)),
-			Vector3f(P_bezier_matrix(0,3),P_bezier_matrix(1,3),P_bezier_matrix(2,3)),
-		};
+		CurvePoint& pt = curve[i];
+		pt.N = pt.N * c + pt.B * s;
+		pt.B = Vector3f::cross(pt.T, pt.N);
+	}
+
+	// Exactly the first frame, so the seam can be welded
+	curve.back().N = first.N;
+	curve.back().B = first.B;
+}
 
-		populateBezierCurveSegment(result, P_bezier, i * steps, steps);
+ArcLengthTable::ArcLengthTable(const Curve& curve)
+	: mLengths(curve.size(), 0.0f)
+{
+	if (curve.empty())
+		return;
+
+	// Chord lengths from separate coordinate arrays, a loop the
+	// compiler can vectorize, then the running sum.
+	size_t n = curve.size();
+	vector<float> x(n), y(n), z(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		x[i] = curve[i].V[0];
+		y[i] = curve[i].V[1];
+		z[i] = curve[i].V[2];
 	}
 
-	return result;
+	float* chord = &mLengths[0];
+	for (size_t i = 1; i < n; ++i)
+	{
+		float dx = x[i] - x[i - 1], dy = y[i] - y[i - 1], dz = z[i] - z[i - 1];
+		chord[i] = sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+	for (size_t i = 1; i < n; ++i)
+		mLengths[i] += mLengths[i - 1];
+}
+
+float ArcLengthTable::indexAt(float distance) const
+{
+	// Written so that NaN goes to the start too
+	if (mLengths.size() < 2 || !(distance > 0.0f))
+		return 0.0f;
+	if (distance >= mLengths.back())
+		return float(mLengths.size() - 1);
+
+	// The first sample past the distance; the chord before it holds it
+	size_t i = upper_bound(mLengths.begin(), mLengths.end(), distance) - mLengths.begin();
+	float chord = mLengths[i] - mLengths[i - 1];
+	float fraction = chord > 0.0f ? (distance - mLengths[i - 1]) / chord : 0.0f;
+	return float(i - 1) + fraction;
+}
+
+EditableBspline::EditableBspline(const vector< Vector3f >& P, unsigned steps)
+	: mP(P), mSteps(steps), mCurve(evalBspline(P, steps))
+{
+}
+
+CurveChange EditableBspline::setControlPoint(unsigned i, const Vector3f& p)
+{
+	mP[i] = p;
+
+	// Control point i weighs into pieces i - 3 .. i
+	unsigned pieces = mP.size() - 3;
+	unsigned first_piece = i < 3 ? 0 : i - 3;
+	unsigned last_piece = min(i, pieces - 1);
+
+	// Evaluate them from a copy of just their control points
+	vector< Vector3f > local(mP.begin() + first_piece, mP.begin() + last_piece + 4);
+	ControlPointsSoA cps(local);
+	const BasisTable& basis = getBasisTable(BSPLINE, mSteps);
+
+	for (unsigned piece = first_piece; piece <= last_piece; ++piece)
+		populateCurveSegment(mCurve, basis, cps, piece - first_piece, piece * mSteps, piece + 1 == pieces);
+
+	CurveChange change;
+	change.first = first_piece * mSteps;
+	unsigned vertex_end = (last_piece + 1) * mSteps + (last_piece + 1 == pieces ? 1 : 0);
+
+	// Frames are propagated forward until one comes out as it was
+	// before; from there on nothing changes.  For a flat curve that
+	// is usually right after the moved pieces.
+	change.end = mCurve.size();
+	for (unsigned k = change.first; k < mCurve.size(); ++k)
+	{
+		Vector3f old_N = mCurve[k].N;
+		Vector3f old_B = mCurve[k].B;
+
+		computeCurveFrame(mCurve, k);
+
+		if (k >= vertex_end && mCurve[k].N == old_N && mCurve[k].B == old_B)
+		{
+			change.end = k;
+			break;
+		}
+	}
+
+	return change;
+}
+
+Curve evalBezier(const vector< Vector3f >& P, const CurveTolerance& tolerance)
+{
+	checkBezierControlPoints(P);
+
+	return evalAdaptive(BEZIER, P, (P.size() - 1) / 3, 3, tolerance);
+}
+
+Curve evalBspline(const vector< Vector3f >& P, const CurveTolerance& tolerance)
+{
+	checkBsplineControlPoints(P);
+
+	return evalAdaptive(BSPLINE, P, P.size() - 3, 1, tolerance);
 }
 
 Curve evalCircle(float radius, unsigned steps)
@@ -162,52 +636,3 @@ Curve evalCircle(float radius, unsigned steps)
 
 	return R;
 }
-
-void drawCurve(const Curve& curve, float framesize)
-{
-	// Save current state of OpenGL
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-	// Setup for line drawing
-	glDisable(GL_LIGHTING);
-	glColor4f(1, 1, 1, 1);
-	glLineWidth(1);
-
-	// Draw curve
-	glBegin(GL_LINE_STRIP);
-	for (unsigned i = 0; i < curve.size(); ++i)
-	{
-		glVertex(curve[i].V);
-	}
-	glEnd();
-
-	glLineWidth(1);
-
-	// Draw coordinate frames if framesize nonzero
-	if (framesize != 0.0f)
-	{
-		Matrix4f M;
-
-		for (unsigned i = 0; i < curve.size(); ++i)
-		{
-			M.setCol(0, Vector4f(curve[i].N, 0));
-			M.setCol(1, Vector4f(curve[i].B, 0));
-			M.setCol(2, Vector4f(curve[i].T, 0));
-			M.setCol(3, Vector4f(curve[i].V, 1));
-
-			glPushMatrix();
-			glMultMatrixf(M);
-			glScaled(framesize, framesize, framesize);
-			glBegin(GL_LINES);
-			glColor3f(1, 0, 0); glVertex3d(0, 0, 0); glVertex3d(1, 0, 0);
-			glColor3f(0, 1, 0); glVertex3d(0, 0, 0); glVertex3d(0, 1, 0);
-			glColor3f(0, 0, 1); glVertex3d(0, 0, 0); glVertex3d(0, 0, 1);
-			glEnd();
-			glPopMatrix();
-		}
-	}
-
-	// Pop state
-	glPopAttrib();
-}
-
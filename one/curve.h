@@ -3,8 +3,13 @@
 
 #include "tuple.h"
 #include <vecmath.h>
+#include <cmath>
 #include <vector>
 
+#ifndef M_PI
+#define M_PI  3.14159265358979
+#endif
+
 // The CurvePoint object stores information about a point on a curve
 // after it has been tesselated: the vertex (V), the tangent (T), the
 // normal (N), and the binormal (B).  It is the responsiblility of
@@ -31,19 +36,121 @@ typedef std::vector< CurvePoint > Curve;
 // control point is shared).
 ////////////////////////////////////////////////////////////////////////////
 
+// How the samples of a fixed-step curve are spread: uniformly in the
+// parameter t of every piece, or evenly by arc length along the whole
+// curve.  Both give the same number of samples.
+enum CurveSpacing
+{
+    PARAMETER_SPACING,
+    ARC_LENGTH_SPACING
+};
+
 // Assume number of control points properly specifies a piecewise
 // Bezier curve.  I.e., C.size() == 4 + 3*n, n=0,1,...
-Curve evalBezier( const std::vector< Vector3f >& P, unsigned steps );
+Curve evalBezier( const std::vector< Vector3f >& P, unsigned steps,
+                  CurveSpacing spacing = PARAMETER_SPACING );
 
 // Bsplines only require that there are at least 4 control points.
-Curve evalBspline( const std::vector< Vector3f >& P, unsigned steps );
+Curve evalBspline( const std::vector< Vector3f >& P, unsigned steps,
+                   CurveSpacing spacing = PARAMETER_SPACING );
 
-// Create a circle on the xy-plane of radius and steps
-Curve evalCircle( float radius, unsigned steps);
+// The cumulative arc length of a curve at each of its samples.  It is
+// built once, in a single pass, and then maps a distance along the
+// curve to a sample position in O(log n): indexAt returns a fractional
+// sample index, e.g. 2.5 halfway between samples 2 and 3.  For a
+// fixed-step curve with parameter spacing, that is STEPS times the
+// parameter of the curve.
+class ArcLengthTable
+{
+public:
+    ArcLengthTable() {}
+    explicit ArcLengthTable( const Curve& curve );
+
+    float length() const { return mLengths.empty() ? 0.0f : mLengths.back(); }
+
+    // Length of the curve up to sample i
+    float lengthAt( unsigned i ) const { return mLengths[ i ]; }
+
+    // The sample position at the given distance from the start,
+    // clamped to the curve.  NaN maps to the start.
+    float indexAt( float distance ) const;
+
+private:
+    std::vector< float > mLengths;
+};
+
+// Tolerances for adaptive tessellation.  Instead of a fixed number of
+// steps, each piece is halved until every sub-interval stays within
+// "chord" of the straight line between its end points, and its
+// tangent turns by no more than "angle" degrees.  A zero tolerance
+// disables that test.
+struct CurveTolerance
+{
+    float chord;
+    float angle;
+};
+
+// Adaptive versions of evalBezier and evalBspline.  The samples are
+// no longer uniform in t: flat runs get few, tight bends get many.
+Curve evalBezier( const std::vector< Vector3f >& P, const CurveTolerance& tolerance );
+Curve evalBspline( const std::vector< Vector3f >& P, const CurveTolerance& tolerance );
+
+// Whether two points (or directions) of a curve count as the same:
+// closer than 1e-5, relative to their distance from the origin but at
+// least absolutely.
+bool sameCurveVector( const Vector3f& a, const Vector3f& b );
+
+// Whether a curve is closed: it has at least four points, and its last
+// point and tangent are the same (sameCurveVector) as the first ones.
+// The frames may still differ there, by a twist about the tangent or
+// at a corner; a surface only wraps around a closed curve whose last
+// frame also matches the first.
+bool closedCurve( const Curve& curve );
 
+// Replaces the normals and binormals of an evaluated curve with
+// rotation minimizing frames, computed by double reflection (Wang et
+// al., "Computation of Rotation Minimizing Frames", 2008) in one pass
+// along the curve.  Unlike the propagated frames of the evaluators
+// they don't drift on long curves.  If the curve is closed (see
+// closedCurve) the twist left over at the end is spread evenly by arc
+// length, so the last frame matches the first one and swept surfaces
+// close without a seam.
+void computeRotationMinimizingFrames( Curve& curve );
 
-// Draw the curve and (optionally) the associated coordinate frames
-// If framesize == 0, then no frames are drawn.  Otherwise, drawn.
-void drawCurve( const Curve& curve, float framesize = 0 );
+// The points of a curve that changed, [first, end).
+struct CurveChange
+{
+    unsigned first;
+    unsigned end;
+};
+
+// A fixed-step B-spline whose control points can be moved one at a
+// time, e.g. while dragging them.  A control point only weighs into
+// the four pieces around it, so moving it re-evaluates just those
+// pieces, and then propagates the frames forward from there for as
+// long as they come out different.  The curve is always the same as
+// evalBspline would return for the current control points.
+class EditableBspline
+{
+public:
+    EditableBspline( const std::vector< Vector3f >& P, unsigned steps );
+
+    const Curve& curve() const { return mCurve; }
+    const std::vector< Vector3f >& controlPoints() const { return mP; }
+    unsigned steps() const { return mSteps; }
+
+    // Moves control point i to p, and returns the points of curve()
+    // that changed.  Pass that on to the update functions in surf.h
+    // to patch the surfaces built from this curve.
+    CurveChange setControlPoint( unsigned i, const Vector3f& p );
+
+private:
+    std::vector< Vector3f > mP;
+    unsigned mSteps;
+    Curve mCurve;
+};
+
+// Create a circle on the xy-plane of radius and steps
+Curve evalCircle( float radius, unsigned steps);
 
 #endif
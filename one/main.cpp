@@ -2,10 +2,14 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <cstdlib>
 #include <fstream>
+#include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #ifdef _WIN32
@@ -20,6 +24,8 @@
 #include "surf.h"
 #include "extra.h"
 #include "camera.h"
+#include "watch.h"
+#include "buffers.h"
 
 using namespace std;
 
@@ -39,17 +45,31 @@ namespace
     int  gCurveMode = 1;
     int  gSurfaceMode = 1;
     int  gPointMode = 1;
+    int  gAOMode = 0;
 
     // This detemines how big to draw the normals
     const float gLineLen = 0.1f;
     
-    // These are arrays for display lists for each drawing mode.  The
-    // convention is that drawmode 0 is "blank", and other drawmodes
-    // just call the appropriate display lists.
-    GLuint gCurveLists[3];
-    GLuint gSurfaceLists[3];
+    // Every object of the file has its own vertex and index buffers
+    // (see buffers.h), so that a reload only uploads the objects that
+    // changed.  The control points of a curve go in a display list.
+    // The drawing modes are as before: mode 0 is "blank", and the
+    // others draw from these.
+    vector<MeshBuffers> gObjectBuffers;
+    vector<GLuint> gPointLists;
     GLuint gAxisList;
-    GLuint gPointList;
+
+    // With frame timing on ('t'), frame times are summed up and their
+    // average printed about once a second.  It is off by default: to
+    // include the drawing, every frame has to wait for the GPU.
+    bool gTimeFrames = false;
+    double gFrameSeconds = 0;
+    unsigned gFrameCount = 0;
+    chrono::steady_clock::time_point gFrameReport;
+
+    // How often the .swp file is checked for changes, in msec
+    const unsigned gWatchInterval = 100;
+    FileWatcher *gWatcher = 0;
    
     // These STL Vectors store the control points, curves, and
     // surfaces that will end up being drawn.  In addition, parallel
@@ -61,6 +81,12 @@ namespace
     vector<Surface> gSurfaces;
     vector<string> gSurfaceNames;
 
+    // The objects of the file as last read, and their hashes, to tell
+    // on reload which ones changed.
+    string gSwpFile;
+    vector<SwpObject> gObjects;
+    vector<uint64_t> gObjectHashes;
+
     // Declarations of functions whose implementations occur later.
     void arcballRotation(int endX, int endY);
     void keyboardFunc( unsigned char key, int x, int y);
@@ -71,7 +97,12 @@ namespace
     void drawScene(void);
     void initRendering();
     void loadObjects(int argc, char *argv[]);
+    void bakeMissingOcclusion();
     void makeDisplayLists();
+    void uploadObject(unsigned i);
+    double bufferMegabytes();
+    void reloadObjects();
+    void watchFunc(int value);
 
     // This function is called whenever a "Normal" key press is
     // received.
@@ -101,6 +132,19 @@ namespace
         case 'P':
             gPointMode = (gPointMode+1)%2;
             break;            
+        case 'o':
+        case 'O':
+            gAOMode = (gAOMode+1)%2;
+            if (gAOMode)
+                bakeMissingOcclusion();
+            break;
+        case 't':
+        case 'T':
+            gTimeFrames = !gTimeFrames;
+            gFrameSeconds = 0;
+            gFrameCount = 0;
+            gFrameReport = chrono::steady_clock::now();
+            break;
         default:
             cout << "Unhandled key press " << key << "." << endl;        
         }
@@ -177,9 +221,27 @@ namespace
         camera.ApplyPerspective();
     }
 
+    void reportFrameTime(chrono::steady_clock::time_point frameStart)
+    {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        gFrameSeconds += chrono::duration<double>(now - frameStart).count();
+        ++gFrameCount;
+
+        if (now - gFrameReport >= chrono::seconds(1))
+        {
+            cerr << "frame time " << gFrameSeconds / gFrameCount * 1e3 << " ms (average of "
+                 << gFrameCount << " frames)" << endl;
+            gFrameSeconds = 0;
+            gFrameCount = 0;
+            gFrameReport = now;
+        }
+    }
+
     // This function is responsible for displaying the object.
     void drawScene(void)
     {
+        chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+
         // Clear the rendering window
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -194,12 +256,27 @@ namespace
 
         camera.ApplyModelview();
 
-        // Call the relevant display lists.
-        if (gSurfaceMode)
-            glCallList(gSurfaceLists[gSurfaceMode]);
+        // Draw from the relevant buffers.
+        for (unsigned i=0; i<gObjects.size(); i++)
+        {
+            if (gObjects[i].isCurve())
+                continue;
+
+            if (gSurfaceMode == 1)
+                drawSurfaceBuffers(gObjectBuffers[i], true, gAOMode != 0);
+            else if (gSurfaceMode == 2)
+            {
+                drawSurfaceBuffers(gObjectBuffers[i], false);
+                drawNormalBuffers(gObjectBuffers[i]);
+            }
+        }
 
         if (gCurveMode)
-            glCallList(gCurveLists[gCurveMode]);
+        {
+            for (unsigned i=0; i<gObjects.size(); i++)
+                if (gObjects[i].isCurve())
+                    drawCurveBuffers(gObjectBuffers[i], gCurveMode == 2);
+        }
 
         // This draws the coordinate axes when you're rotating, to
         // keep yourself oriented.
@@ -212,12 +289,22 @@ namespace
         }
 
         if (gPointMode)
-            glCallList(gPointList);
-                 
+        {
+            for (unsigned i=0; i<gObjects.size(); i++)
+                if (gObjects[i].isCurve())
+                    glCallList(gPointLists[i]);
+        }
+
+        // Wait for the GPU so that the frame time includes the drawing.
+        if (gTimeFrames)
+        {
+            glFinish();
+            reportFrameTime(frameStart);
+        }
+
         // Dump the image to the screen.
         glutSwapBuffers();
 
-
     }
 
     // Initialize OpenGL's rendering modes
@@ -255,6 +342,34 @@ namespace
         glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
     }
 
+    // Makes objects, evaluated into curves and surfaces, the scene:
+    // fills gObjects, gObjectHashes, gCtrlPoints, gCurves,
+    // gCurveNames, gSurfaces and gSurfaceNames.
+    void setScene(vector<SwpObject> &objects,
+                  vector<Curve> &curves,
+                  vector<Surface> &surfaces)
+    {
+        gObjects.swap(objects);
+        gCurves.swap(curves);
+        gSurfaces.swap(surfaces);
+
+        gObjectHashes.clear();
+        gCtrlPoints.clear();
+        gCurveNames.clear();
+        gSurfaceNames.clear();
+
+        for (unsigned i=0; i<gObjects.size(); i++)
+        {
+            gObjectHashes.push_back(hashSwpObject(gObjects[i], gObjects));
+            gCtrlPoints.push_back(gObjects[i].cps);
+
+            if (gObjects[i].isCurve())
+                gCurveNames.push_back(gObjects[i].name);
+            else
+                gSurfaceNames.push_back(gObjects[i].name);
+        }
+    }
+
     // Load in objects from standard input into the global variables: 
     // gCtrlPoints, gCurves, gCurveNames, gSurfaces, gSurfaceNames.  If
     // loading fails, this will exit the program.
@@ -262,7 +377,7 @@ namespace
     {
         if (argc < 2)
         {
-            cerr<< "usage: " << argv[0] << " SWPFILE [OBJPREFIX] " << endl;
+            cerr<< "usage: " << argv[0] << " SWPFILE [OBJPREFIX [obj|ply|plyascii]] " << endl;
             exit(0);
         }
 
@@ -276,9 +391,10 @@ namespace
         
         cerr << endl << "*** loading and constructing curves and surfaces ***" << endl;
         
-        if (!parseFile(in, gCtrlPoints,
-                       gCurves, gCurveNames,
-                       gSurfaces, gSurfaceNames))
+        gSwpFile = argv[1];
+
+        vector<SwpObject> objects;
+        if (!readSwpObjects(in, objects))
         {
             cerr << "\aerror in file format\a" << endl;
             in.close();
@@ -287,12 +403,27 @@ namespace
 
         in.close();
 
-        // This does OBJ file output
+        vector<Curve> curves;
+        vector<Surface> surfaces;
+        evalSwpObjects(objects, curves, surfaces);
+        setScene(objects, curves, surfaces);
+
+        // This does OBJ (or PLY) file output
         if (argc > 2)
         {
-            cerr << endl << "*** writing obj files ***" << endl;
+            string format(argc > 3 ? argv[3] : "obj");
+            if (format != "obj" && format != "ply" && format != "plyascii")
+            {
+                cerr << "unknown output format " << format << ", writing obj" << endl;
+                format = "obj";
+            }
+
+            cerr << endl << "*** writing " << format << " files ***" << endl;
             
             string prefix(argv[2]);
+            string extension = format == "obj" ? ".obj" : ".ply";
+            double totalMegabytes = 0;
+            double totalSeconds = 0;
 
             for (unsigned i=0; i<gSurfaceNames.size(); i++)
             {
@@ -301,9 +432,11 @@ namespace
                     string filename =
                         prefix + string("_")
                         + gSurfaceNames[i]
-                        + string(".obj");
+                        + extension;
+
+                    chrono::steady_clock::time_point start = chrono::steady_clock::now();
 
-                    ofstream out(filename.c_str());
+                    ofstream out(filename.c_str(), format == "ply" ? ios::binary : ios::out);
 
                     if (!out)
                     {
@@ -313,12 +446,25 @@ namespace
                     }
                     else
                     {
-                        outputObjFile(out, gSurfaces[i]);
-                        cerr << "wrote " << filename <<  endl;
+                        if (format == "obj")
+                            outputObjFile(out, gSurfaces[i]);
+                        else
+                            outputPlyFile(out, gSurfaces[i], format == "ply");
+
+                        double megabytes = double(out.tellp()) / (1024 * 1024);
+                        out.close();
+                        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+                        totalMegabytes += megabytes;
+                        totalSeconds += seconds;
+                        cerr << "wrote " << filename << " (" << megabytes << " MB, "
+                             << megabytes / max(seconds, 1e-9) << " MB/s)" << endl;
                     }
                 }
             }
-            
+
+            cerr << "total " << totalMegabytes << " MB in " << totalSeconds << " s ("
+                 << totalMegabytes / max(totalSeconds, 1e-9) << " MB/s)" << endl;
         }
 
         cerr << endl << "*** done ***" << endl;
@@ -326,47 +472,263 @@ namespace
 
     }
 
-    void makeDisplayLists()
+    // Bakes ambient occlusion for surface i.  The results are cached
+    // next to the .swp file, one file per surface.
+    void bakeSurfaceOcclusion(unsigned i)
     {
-        gCurveLists[1] = glGenLists(1);
-        gCurveLists[2] = glGenLists(1);
-        gSurfaceLists[1] = glGenLists(1);
-        gSurfaceLists[2] = glGenLists(1);
-        gAxisList = glGenLists(1);
-        gPointList = glGenLists(1);
+        ostringstream cacheFile;
+        cacheFile << gSwpFile << "_" << i << ".ao";
 
-        // Compile the display lists
-        
-        glNewList(gCurveLists[1], GL_COMPILE);
+        cerr << ">surface " << i << " [" << gSurfaceNames[i] << "]" << endl;
+        bakeSurfaceAO(gSurfaces[i], cacheFile.str());
+    }
+
+    // Bakes ambient occlusion for the surfaces that have none for
+    // their current geometry, and uploads them again.  AO is only baked
+    // once it is shown, so runs that never turn it on (exports, say)
+    // don't pay for it.
+    void bakeMissingOcclusion()
+    {
+        bool header = false;
+        for (unsigned i=0; i<gObjects.size(); i++)
         {
-            for (unsigned i=0; i<gCurves.size(); i++)
-                drawCurve(gCurves[i], 0.0);
+            if (gObjects[i].isCurve())
+                continue;
+
+            const Surface &surface = gSurfaces[gObjects[i].index];
+            if (surface.AO.size() == surface.VV.size())
+                continue;
+
+            if (!header)
+                cerr << endl << "*** baking ambient occlusion ***" << endl;
+            header = true;
+
+            bakeSurfaceOcclusion(gObjects[i].index);
+            uploadObject(i);
         }
-        glEndList();
-                
-        glNewList(gCurveLists[2], GL_COMPILE);
+    }
+
+    // The key an object is matched by on reload: its name, or for
+    // anonymous objects their order among the anonymous ones.
+    string reloadKey(const SwpObject &object, unsigned &anonymous)
+    {
+        if (object.name != ".")
+            return object.name;
+
+        ostringstream key;
+        key << ". " << anonymous++;
+        return key.str();
+    }
+
+    // Re-reads the .swp file after it changed.  Objects are matched
+    // to the previous ones with reloadKey.  Only the curves whose
+    // description changed, and the surfaces that are new, changed or
+    // use such a curve, are evaluated and get new buffers;
+    // everything else is kept as it was.
+    void reloadObjects()
+    {
+        typedef chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+
+        cerr << endl << "*** reloading " << gSwpFile << " ***" << endl;
+
+        ifstream in(gSwpFile.c_str());
+        ostringstream log;
+        vector<SwpObject> objects;
+        if (!in || !readSwpObjects(in, objects, log))
         {
-            for (unsigned i=0; i<gCurves.size(); i++)
-                drawCurve(gCurves[i], gLineLen);
+            cerr << log.str() << "reload failed, keeping the previous objects" << endl;
+            return;
         }
-        glEndList();
-        
-        glNewList(gSurfaceLists[1], GL_COMPILE);
+        in.close();
+
+        // An empty read of a file that had objects is most likely a
+        // save caught halfway, not an edit
+        if (objects.empty() && !gObjects.empty())
         {
-            for (unsigned i=0; i<gSurfaces.size(); i++)
-                drawSurface(gSurfaces[i], true);
+            cerr << "no objects read, keeping the previous objects" << endl;
+            return;
         }
-        glEndList();
+        Clock::time_point parsed = Clock::now();
+
+        // Where each object was in the previous file
+        unordered_map<string,unsigned> previous;
+        unsigned anonymous = 0;
+        for (unsigned i=0; i<gObjects.size(); i++)
+            previous[reloadKey(gObjects[i], anonymous)] = i;
+
+        // Move over what didn't change.  Curves always come before the
+        // surfaces that use them, so their flags are already set.
+        vector<Curve> curves;
+        vector<Surface> surfaces;
+        vector<bool> dirty(objects.size(), true);
+        vector<MeshBuffers> buffers(objects.size());
+        vector<GLuint> pointLists(objects.size(), 0);
+        unsigned dirtyCount = 0;
+        anonymous = 0;
+
+        for (unsigned i=0; i<objects.size(); i++)
+        {
+            const SwpObject &object = objects[i];
+            if (object.isCurve())
+                curves.push_back(Curve());
+            else
+                surfaces.push_back(Surface());
+
+            unordered_map<string,unsigned>::const_iterator it =
+                previous.find(reloadKey(object, anonymous));
+
+            if (it != previous.end())
+            {
+                unsigned j = it->second;
+
+                bool same = gObjects[j].isCurve() == object.isCurve() &&
+                    gObjectHashes[j] == hashSwpObject(object, objects);
+                if (same && !object.isCurve())
+                    same = !dirty[object.profile] &&
+                        (object.type != "gcyl" || !dirty[object.sweep]);
 
-        glNewList(gSurfaceLists[2], GL_COMPILE);
+                if (same)
+                {
+                    if (object.isCurve())
+                        curves.back().swap(gCurves[gObjects[j].index]);
+                    else
+                        swap(surfaces.back(), gSurfaces[gObjects[j].index]);
+
+                    dirty[i] = false;
+                    buffers[i] = gObjectBuffers[j];
+                    pointLists[i] = gPointLists[j];
+                    gObjectBuffers[j] = MeshBuffers();
+                    gPointLists[j] = 0;
+                }
+            }
+
+            if (dirty[i])
+                ++dirtyCount;
+        }
+
+        evalSwpObjects(objects, curves, surfaces, cerr, 0, &dirty);
+        Clock::time_point evaluated = Clock::now();
+
+        // The buffers of objects that changed or went away
+        for (unsigned j=0; j<gObjectBuffers.size(); j++)
         {
-            for (unsigned i=0; i<gSurfaces.size(); i++)
+            deleteMeshBuffers(gObjectBuffers[j]);
+            if (gPointLists[j] != 0)
+                glDeleteLists(gPointLists[j], 1);
+        }
+
+        setScene(objects, curves, surfaces);
+        gObjectBuffers.swap(buffers);
+        gPointLists.swap(pointLists);
+
+        // AO only once it is shown, see bakeMissingOcclusion
+        for (unsigned i=0; i<gObjects.size(); i++)
+            if (gAOMode && dirty[i] && !gObjects[i].isCurve())
+                bakeSurfaceOcclusion(gObjects[i].index);
+        Clock::time_point baked = Clock::now();
+
+        size_t uploadedBytes = 0;
+        for (unsigned i=0; i<gObjects.size(); i++)
+            if (dirty[i])
             {
-                drawSurface(gSurfaces[i], false);
-                drawNormals(gSurfaces[i], gLineLen);
+                uploadObject(i);
+                uploadedBytes += gObjectBuffers[i].bytes;
             }
+        Clock::time_point uploaded = Clock::now();
+
+        typedef chrono::duration<double, milli> Milliseconds;
+        cerr << "reloaded " << dirtyCount << " of " << gObjects.size() << " objects in "
+             << Milliseconds(uploaded - start).count() << " ms (parse "
+             << Milliseconds(parsed - start).count() << " ms, tessellate "
+             << Milliseconds(evaluated - parsed).count() << " ms, ao "
+             << Milliseconds(baked - evaluated).count() << " ms, upload "
+             << Milliseconds(uploaded - baked).count() << " ms)" << endl;
+        cerr << "uploaded " << uploadedBytes / (1024.0 * 1024.0) << " MB, "
+             << bufferMegabytes() << " MB of buffers in total" << endl;
+    }
+
+    // Called every gWatchInterval msec to pick up edits of the .swp
+    // file.
+    void watchFunc(int value)
+    {
+        if (gWatcher->changed())
+        {
+            reloadObjects();
+            glutPostRedisplay();
         }
-        glEndList();
+
+        glutTimerFunc(gWatchInterval, watchFunc, value);
+    }
+
+    // Uploads the buffers of object i, and compiles the control point
+    // list of a curve.
+    void uploadObject(unsigned i)
+    {
+        const SwpObject &object = gObjects[i];
+
+        if (object.isCurve())
+        {
+            uploadCurve(gObjectBuffers[i], gCurves[object.index], gLineLen);
+
+            gPointLists[i] = glGenLists(1);
+            glNewList(gPointLists[i], GL_COMPILE);
+            {
+                // Save current state of OpenGL
+                glPushAttrib(GL_ALL_ATTRIB_BITS);
+
+                // Setup for point drawing
+                glDisable(GL_LIGHTING);    
+                glColor4f(1,1,0.0,1);
+                glPointSize(4);
+                glLineWidth(1);
+
+                glBegin(GL_POINTS);
+                for (unsigned j=0; j<gCtrlPoints[i].size(); j++)
+                    glVertex(gCtrlPoints[i][j]);
+                glEnd();
+
+                glBegin(GL_LINE_STRIP);
+                for (unsigned j=0; j<gCtrlPoints[i].size(); j++)
+                    glVertex(gCtrlPoints[i][j]);
+                glEnd();
+
+                glPopAttrib();
+            }
+            glEndList();
+        }
+        else
+        {
+            uploadSurface(gObjectBuffers[i], gSurfaces[object.index], gLineLen);
+        }
+    }
+
+    // GPU memory of all the object buffers
+    double bufferMegabytes()
+    {
+        size_t bytes = 0;
+        for (unsigned i=0; i<gObjectBuffers.size(); i++)
+            bytes += gObjectBuffers[i].bytes;
+        return (bytes + sharedBufferBytes()) / (1024.0 * 1024.0);
+    }
+
+    void makeDisplayLists()
+    {
+        gAxisList = glGenLists(1);
+
+        // Upload the objects
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        gObjectBuffers.assign(gObjects.size(), MeshBuffers());
+        gPointLists.assign(gObjects.size(), 0);
+        for (unsigned i=0; i<gObjects.size(); i++)
+            uploadObject(i);
+        glFinish();
+
+        cerr << "uploaded " << gObjects.size() << " objects in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()
+             << " ms, " << bufferMegabytes() << " MB of buffers ("
+             << sharedBufferCount() << " shared index buffers)" << endl;
 
         glNewList(gAxisList, GL_COMPILE);
         {
@@ -395,34 +757,6 @@ namespace
         }
         glEndList();
 
-        glNewList(gPointList, GL_COMPILE);
-        {
-            // Save current state of OpenGL
-            glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-            // Setup for point drawing
-            glDisable(GL_LIGHTING);    
-            glColor4f(1,1,0.0,1);
-            glPointSize(4);
-            glLineWidth(1);
-
-            for (unsigned i=0; i<gCtrlPoints.size(); i++)
-            {
-                glBegin(GL_POINTS);
-                for (unsigned j=0; j<gCtrlPoints[i].size(); j++)
-                    glVertex(gCtrlPoints[i][j]);
-                glEnd();
-
-                glBegin(GL_LINE_STRIP);
-                for (unsigned j=0; j<gCtrlPoints[i].size(); j++)
-                    glVertex(gCtrlPoints[i][j]);
-                glEnd();
-            }
-            
-            glPopAttrib();
-        }
-        glEndList();
-
     }
     
 }
@@ -453,6 +787,12 @@ int main( int argc, char* argv[] )
     // Initialize OpenGL parameters.
     initRendering();
 
+    if (!loadBufferFunctions())
+    {
+        cerr << "OpenGL 1.5 buffer objects are not supported" << endl;
+        exit(1);
+    }
+
     // Set up callback functions for key presses
     glutKeyboardFunc(keyboardFunc); // Handles "normal" ascii symbols
     glutSpecialFunc(specialFunc);   // Handles "special" keyboard keys
@@ -467,10 +807,11 @@ int main( int argc, char* argv[] )
     // Call this whenever window needs redrawing
     glutDisplayFunc( drawScene );
 
-    // Trigger timerFunc every 20 msec
-    //  glutTimerFunc(20, timerFunc, 0);
-
     makeDisplayLists();
+
+    // Reload the objects whenever the .swp file is saved
+    gWatcher = new FileWatcher(argv[1]);
+    glutTimerFunc(gWatchInterval, watchFunc, 0);
         
     // Start the main loop.  glutMainLoop never returns.
     glutMainLoop();
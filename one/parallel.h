@@ -0,0 +1,76 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// True on a thread that is already doing its share of some parallel
+// work: a ThreadPool worker, or a block of a parallelFor.
+inline bool& insideParallelWork()
+{
+	static thread_local bool inside = false;
+	return inside;
+}
+
+// Marks the current thread as inside parallel work for its lifetime.
+class ParallelWorkScope
+{
+public:
+	ParallelWorkScope() : outer(insideParallelWork()) { insideParallelWork() = true; }
+	~ParallelWorkScope() { insideParallelWork() = outer; }
+
+private:
+	ParallelWorkScope(const ParallelWorkScope&);
+	ParallelWorkScope& operator=(const ParallelWorkScope&);
+
+	bool outer;
+};
+
+// Calls body(i) for every i in [begin, end).  The range is cut into
+// one contiguous block per hardware thread, but never into blocks
+// smaller than grain, so short loops just run on the calling thread.
+// Loops nested in parallel work (a pool task, or another parallelFor)
+// run on the calling thread too, since the cores are busy already.
+// body must be safe to call concurrently for different i.
+template <typename Body>
+void parallelFor(size_t begin, size_t end, size_t grain, const Body& body)
+{
+	size_t count = end > begin ? end - begin : 0;
+	size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	size_t blocks = std::min(hardwareThreads, count / std::max<size_t>(grain, 1));
+
+	if (blocks <= 1 || insideParallelWork())
+	{
+		for (size_t i = begin; i < end; ++i)
+			body(i);
+		return;
+	}
+
+	ParallelWorkScope scope;
+
+	size_t blockSize = (count + blocks - 1) / blocks;
+	std::vector<std::thread> threads;
+	threads.reserve(blocks - 1);
+
+	for (size_t first = begin + blockSize; first < end; first += blockSize)
+	{
+		size_t last = std::min(end, first + blockSize);
+		threads.push_back(std::thread([first, last, &body]()
+		{
+			ParallelWorkScope scope;
+			for (size_t i = first; i < last; ++i)
+				body(i);
+		}));
+	}
+
+	// The calling thread takes the first block
+	for (size_t i = begin; i < std::min(end, begin + blockSize); ++i)
+		body(i);
+
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+}
+
+#endif
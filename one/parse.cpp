@@ -1,18 +1,25 @@
 #include "parse.h"
-#include <map>
+#include "threadpool.h"
+#include <cctype>
+#include <cstdlib>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
 using namespace std;
 
 
 namespace {
 
     // read in dim-dimensional control points into a vector
-    vector<Vector3f> readCps(istream &in, unsigned dim)
+    vector<Vector3f> readCps(istream &in, unsigned dim, ostream &log)
     {    
         // number of control points    
         unsigned n;
         in >> n;
 
-        cerr << "  " << n << " cps" << endl;
+        log << "  " << n << " cps" << endl;
     
         // vector of control points
         vector<Vector3f> cps(n);
@@ -48,179 +55,403 @@ namespace {
 
         return cps;
     }
+
+    // Read the optional OPTION=VALUE tokens between STEPS and
+    // NUMPOINTS.  Sets adaptive if a tolerance was given.
+    bool readCurveOptions(istream &in, SwpObject &curve, ostream &log)
+    {
+        CurveTolerance &tolerance = curve.tolerance;
+        bool &adaptive = curve.adaptive;
+
+        while ((in >> ws) && isalpha(in.peek()))
+        {
+            string option;
+            in >> option;
+
+            string::size_type eq = option.find('=');
+            string key = option.substr(0, eq);
+            float value = (eq == string::npos) ? 0.0f : float(atof(option.c_str() + eq + 1));
+
+            if (key == "sampling")
+            {
+                string mode = (eq == string::npos) ? "" : option.substr(eq + 1);
+                if (mode != "arclength" && mode != "uniform")
+                {
+                    log << "failed: unknown sampling " << mode << endl;
+                    return false;
+                }
+
+                curve.spacing = (mode == "arclength") ? ARC_LENGTH_SPACING : PARAMETER_SPACING;
+                log << "  sampling [" << mode << "]" << endl;
+                continue;
+            }
+
+            if (key == "frames")
+            {
+                string mode = (eq == string::npos) ? "" : option.substr(eq + 1);
+                if (mode != "rmf" && mode != "propagate")
+                {
+                    log << "failed: unknown frames " << mode << endl;
+                    return false;
+                }
+
+                curve.rotationMinimizing = (mode == "rmf");
+                log << "  frames [" << mode << "]" << endl;
+                continue;
+            }
+
+            if (key == "tol")
+                tolerance.chord = value;
+            else if (key == "angle")
+                tolerance.angle = value;
+            else
+            {
+                log << "failed: unknown option " << option << endl;
+                return false;
+            }
+
+            log << "  " << key << " [" << value << "]" << endl;
+            adaptive = true;
+        }
+
+        // Adaptive samples follow the curvature, so they can't be evenly
+        // spaced as well.
+        if (adaptive && curve.spacing == ARC_LENGTH_SPACING)
+        {
+            log << "failed: sampling=arclength can't be combined with a tolerance" << endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Checks the steps and control point count of a Bezier or
+    // B-spline curve, so that evaluating it later can't fail.  Sets the
+    // number of samples of the fixed-step evaluation.
+    bool checkCurve(SwpObject &curve, bool bezier, ostream &log)
+    {
+        if (curve.steps == 0)
+        {
+            log << "failed: [" << curve.name << "] needs at least 1 step" << endl;
+            return false;
+        }
+
+        unsigned n = curve.cps.size();
+        if (bezier ? (n < 4 || n % 3 != 1) : n < 4)
+        {
+            log << "failed: [" << curve.name << "] needs "
+                << (bezier ? "3n+1" : "4 or more") << " control points" << endl;
+            return false;
+        }
+
+        unsigned pieces = bezier ? (n - 1) / 3 : n - 3;
+        curve.fixedSize = curve.steps * pieces + 1;
+        return true;
+    }
+
+    // FNV-1a over the bytes of the object description
+    void hashBytes(uint64_t &hash, const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    void hashString(uint64_t &hash, const string &text)
+    {
+        // The terminating zero keeps "ab"+"c" apart from "a"+"bc"
+        hashBytes(hash, text.c_str(), text.size() + 1);
+    }
+
+    // Looks up a named curve for a surface.  If dim is nonzero the
+    // curve must have that dimension.
+    bool findCurve(const unordered_map<string,unsigned> &curveIndex,
+                   const vector<SwpObject> &objects,
+                   const string &name, unsigned dim,
+                   unsigned &object, ostream &log)
+    {
+        unordered_map<string,unsigned>::const_iterator it = curveIndex.find(name);
+
+        if (it == curveIndex.end()) {                
+            log << "failed: [" << name << "] doesn't exist!" << endl; return false;
+        }
+        if (dim != 0 && objects[it->second].dim != dim) {
+            log << "failed: [" << name << "] isn't " << dim << "d!" << endl; return false;
+        }
+
+        object = it->second;
+        return true;
+    }
 }
 
 
 
-bool parseFile(istream &in,
-               vector<vector<Vector3f> > &ctrlPoints, 
-               vector<Curve>             &curves,
-               vector<string>            &curveNames,
-               vector<Surface>           &surfaces,
-               vector<string>            &surfaceNames)
+bool readSwpObjects(istream &in, vector<SwpObject> &objects, ostream &log)
 {
-    ctrlPoints.clear();
-    curves.clear();
-    curveNames.clear();
-    surfaces.clear();
-    surfaceNames.clear();    
-    
+    objects.clear();
+
     string objType;
 
-    // For looking up curve indices by name
-    map<string,unsigned> curveIndex;
+    // For looking up curve objects by name
+    unordered_map<string,unsigned> curveIndex;
 
-    // For looking up surface indices by name
-    map<string,unsigned> surfaceIndex;
-        
-    // For storing dimension of curve
-    vector<unsigned> dims;
+    // For looking up surface objects by name
+    unordered_map<string,unsigned> surfaceIndex;
 
-    unsigned counter = 0;
+    unsigned curveCount = 0;
+    unsigned surfaceCount = 0;
     
     while (in >> objType) 
     {
-        cerr << ">object " << counter++ << endl;
-        string objName;
-        in >> objName;
+        log << ">object " << objects.size() << endl;
+
+        SwpObject object;
+        object.type = objType;
+        in >> object.name;
 
+        const string &objName = object.name;
         bool named = (objName != ".");
         
-        vector<Vector3f> cpsToAdd;
-        
         if (curveIndex.find(objName) != curveIndex.end() ||
             surfaceIndex.find(objName) != surfaceIndex.end())
         {
-            cerr << "error, [" << objName << "] already exists" << endl;
+            log << "error, [" << objName << "] already exists" << endl;
             return false;
         }
 
-        unsigned steps;
-
-        if (objType == "bez2")
+        if (objType == "bez2" || objType == "bsp2" ||
+            objType == "bez3" || objType == "bsp3")
         {
-            in >> steps;
-            cerr << " reading bez2 " << "[" << objName << "]" << endl;
-            curves.push_back( evalBezier(cpsToAdd = readCps(in, 2), steps) );
-            curveNames.push_back(objName);
-            dims.push_back(2);
-            if (named) curveIndex[objName] = dims.size()-1;
-            
-        }
-        else if (objType == "bsp2")
-        {
-            cerr << " reading bsp2 " << "[" << objName << "]" << endl;
-            in >> steps;
-            curves.push_back( evalBspline(cpsToAdd = readCps(in, 2), steps) );
-            curveNames.push_back(objName);
-            dims.push_back(2);
-            if (named) curveIndex[objName] = dims.size()-1;
+            bool bezier = (objType[1] == 'e');
+            object.dim = objType[3] - '0';
+
+            log << " reading " << objType << " [" << objName << "]" << endl;
+            in >> object.steps;
+            if (!readCurveOptions(in, object, log)) return false;
+            object.cps = readCps(in, object.dim, log);
+            if (!checkCurve(object, bezier, log)) return false;
         }
-        else if (objType == "bez3")
+        else if (objType == "circ")
         {
-            cerr << " reading bez3 " << "[" << objName << "]" << endl;
-            in >> steps;
-            curves.push_back( evalBezier(cpsToAdd = readCps(in, 3), steps) );
-            curveNames.push_back(objName);
-            dims.push_back(3);
-            if (named) curveIndex[objName] = dims.size()-1;
+            log << " reading circ " << "[" << objName << "]" << endl;
 
-        }
-        else if (objType == "bsp3")
-        {
-            cerr << " reading bsp3 " << "[" << objName << "]" << endl;
-            in >> steps;
-            curves.push_back( evalBspline(cpsToAdd = readCps(in, 3), steps) );
-            curveNames.push_back(objName);
-            dims.push_back(3);
-            if (named) curveIndex[objName] = dims.size()-1;
+            object.dim = 2;
+            in >> object.steps >> object.radius;
+            log << "  radius [" << object.radius << "]" << endl;
+
+            object.fixedSize = object.steps + 1;
         }
         else if (objType == "srev")
         {
-            cerr << " reading srev " << "[" << objName << "]" << endl;
-            in >> steps;
+            log << " reading srev " << "[" << objName << "]" << endl;
+            in >> object.steps;
 
             // Name of the profile curve
             string profName;
             in >> profName;
 
-            cerr << "  profile [" << profName << "]" << endl;
-            
-            map<string,unsigned>::const_iterator it = curveIndex.find(profName);
+            log << "  profile [" << profName << "]" << endl;
 
-            // Failure checks
-            if (it == curveIndex.end()) {                
-                cerr << "failed: [" << profName << "] doesn't exist!" << endl; return false;
-            }
-            if (dims[it->second] != 2) {
-                cerr << "failed: [" << profName << "] isn't 2d!" << endl; return false;
-            }
+            if (!findCurve(curveIndex, objects, profName, 2, object.profile, log)) return false;
 
-            // Make the surface
-            surfaces.push_back( makeSurfRev( curves[it->second], steps ) );
-            surfaceNames.push_back(objName);
-            if (named) surfaceIndex[objName] = surfaceNames.size()-1;
+            object.fixedTriangles = 2 * (objects[object.profile].fixedSize - 1) * object.steps;
         }
         else if (objType == "gcyl")
         {
-            cerr << " reading gcyl " << "[" << objName << "]" << endl;
+            log << " reading gcyl " << "[" << objName << "]" << endl;
             
             // Name of the profile curve and sweep curve
             string profName, sweepName;
             in >> profName >> sweepName;
 
-            cerr << "  profile [" << profName << "], sweep [" << sweepName << "]" << endl;
+            log << "  profile [" << profName << "], sweep [" << sweepName << "]" << endl;
 
-            map<string,unsigned>::const_iterator itP, itS;
-
-            // Failure checks for profile
-            itP = curveIndex.find(profName);
-            
-            if (itP == curveIndex.end()) {                
-                cerr << "failed: [" << profName << "] doesn't exist!" << endl; return false;
-            }
-            if (dims[itP->second] != 2) {
-                cerr << "failed: [" << profName << "] isn't 2d!" << endl; return false;
-            }
-
-            // Failure checks for sweep
-            itS = curveIndex.find(sweepName);
-            if (itS == curveIndex.end()) {                
-                cerr << "failed: [" << sweepName << "] doesn't exist!" << endl; return false;
-            }
-
-            // Make the surface
-            surfaces.push_back( makeGenCyl( curves[itP->second], curves[itS->second] ) );
-            surfaceNames.push_back(objName);
-            if (named) surfaceIndex[objName] = surfaceNames.size()-1;
+            if (!findCurve(curveIndex, objects, profName, 2, object.profile, log)) return false;
+            if (!findCurve(curveIndex, objects, sweepName, 0, object.sweep, log)) return false;
 
+            object.fixedTriangles = 2 * (objects[object.profile].fixedSize - 1) *
+                                        (objects[object.sweep].fixedSize - 1);
         }
-        else if (objType == "circ")
+        else
         {
-            cerr << " reading circ " << "[" << objName << "]" << endl;
-
-            unsigned steps;
-            float rad;
-            in >> steps >> rad;
-            cerr << "  radius [" << rad << "]" << endl;
+            log << "failed: type " << objType << " unrecognized." << endl;
+            return false;
+        }
 
-            curves.push_back( evalCircle(rad, steps) );
-            curveNames.push_back(objName);
-            dims.push_back(2);
-            if (named) curveIndex[objName] = dims.size()-1;
+        if (object.isCurve())
+        {
+            object.index = curveCount++;
+            if (named) curveIndex[objName] = objects.size();
         }
         else
         {
-            cerr << "failed: type " << objType << " unrecognized." << endl;
-            return false;
+            object.index = surfaceCount++;
+            if (named) surfaceIndex[objName] = objects.size();
         }
 
-        ctrlPoints.push_back(cpsToAdd);
+        objects.push_back(object);
     }
 
     return true;
 }
 
+Curve evalSwpCurve(const SwpObject &curve, ostream &log)
+{
+    if (curve.type == "circ")
+        return evalCircle(curve.radius, curve.steps);
+
+    bool bezier = (curve.type[1] == 'e');
+
+    if (!curve.adaptive)
+    {
+        Curve result = bezier ? evalBezier(curve.cps, curve.steps, curve.spacing)
+                              : evalBspline(curve.cps, curve.steps, curve.spacing);
+        if (curve.rotationMinimizing)
+            computeRotationMinimizingFrames(result);
+        return result;
+    }
 
+    Curve result = bezier ? evalBezier(curve.cps, curve.tolerance) : evalBspline(curve.cps, curve.tolerance);
+    if (curve.rotationMinimizing)
+        computeRotationMinimizingFrames(result);
 
+    log << "  [" << curve.name << "] adaptive: " << result.size()
+        << " samples (fixed-step: " << curve.fixedSize << ")" << endl;
+
+    return result;
+}
+
+Surface makeSwpSurface(const SwpObject &surface, const vector<SwpObject> &objects,
+                       const vector<Curve> &curves, ostream &log)
+{
+    const Curve &profile = curves[objects[surface.profile].index];
+
+    Surface result = (surface.type == "srev")
+        ? makeSurfRev(profile, surface.steps)
+        : makeGenCyl(profile, curves[objects[surface.sweep].index]);
+
+    // Report the triangle count, next to what it would be with the
+    // fixed-step curves if any of them was adaptive.
+    log << "  [" << surface.name << "] triangles: " << result.VF.size();
+    if (result.VF.size() != surface.fixedTriangles)
+        log << " (fixed-step: " << surface.fixedTriangles << ")";
+    log << endl;
+
+    return result;
+}
+
+uint64_t hashSwpObject(const SwpObject &object, const vector<SwpObject> &objects)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    hashString(hash, object.type);
+    hashBytes(hash, &object.steps, sizeof(object.steps));
+
+    if (object.isCurve())
+    {
+        hashBytes(hash, &object.adaptive, sizeof(object.adaptive));
+        hashBytes(hash, &object.spacing, sizeof(object.spacing));
+        hashBytes(hash, &object.rotationMinimizing, sizeof(object.rotationMinimizing));
+        hashBytes(hash, &object.tolerance.chord, sizeof(object.tolerance.chord));
+        hashBytes(hash, &object.tolerance.angle, sizeof(object.tolerance.angle));
+        hashBytes(hash, &object.radius, sizeof(object.radius));
+        for (unsigned i = 0; i < object.cps.size(); ++i)
+            hashBytes(hash, static_cast<const float*>(object.cps[i]), 3 * sizeof(float));
+    }
+    else
+    {
+        hashString(hash, objects[object.profile].name);
+        if (object.type == "gcyl")
+            hashString(hash, objects[object.sweep].name);
+    }
 
+    return hash;
+}
+
+void evalSwpObjects(const vector<SwpObject> &objects,
+                    vector<Curve> &curves,
+                    vector<Surface> &surfaces,
+                    ostream &log,
+                    unsigned threads,
+                    const vector<bool> *dirty)
+{
+    unsigned curveCount = 0, surfaceCount = 0;
+
+    // The graph: the surfaces that use each curve, and the number of
+    // curves each surface still waits for.  Clean curves are done
+    // already, so nothing waits for them.
+    vector< vector<unsigned> > dependents(objects.size());
+    vector< atomic<unsigned> > waiting(objects.size());
+
+    for (unsigned i = 0; i < objects.size(); ++i)
+    {
+        const SwpObject &object = objects[i];
+        waiting[i] = 0;
+
+        if (object.isCurve())
+        {
+            ++curveCount;
+            continue;
+        }
+
+        ++surfaceCount;
+        if (dirty && !(*dirty)[i])
+            continue;
+
+        if (!dirty || (*dirty)[object.profile])
+        {
+            ++waiting[i];
+            dependents[object.profile].push_back(i);
+        }
+        if (object.type == "gcyl" && (!dirty || (*dirty)[object.sweep]))
+        {
+            ++waiting[i];
+            dependents[object.sweep].push_back(i);
+        }
+    }
+
+    if (!dirty)
+    {
+        curves.assign(curveCount, Curve());
+        surfaces.assign(surfaceCount, Surface());
+    }
+
+    ThreadPool pool(threads);
+
+    // Each object logs to its own buffer, written out in file order
+    // once everything is done
+    vector<string> messages(objects.size());
+
+    // Evaluates an object, then submits the surfaces that no longer
+    // wait for anything
+    function<void(unsigned)> evaluate = [&](unsigned i)
+    {
+        const SwpObject &object = objects[i];
+        ostringstream message;
+
+        if (object.isCurve())
+            curves[object.index] = evalSwpCurve(object, message);
+        else
+            surfaces[object.index] = makeSwpSurface(object, objects, curves, message);
+        messages[i] = message.str();
+
+        for (unsigned j = 0; j < dependents[i].size(); ++j)
+        {
+            unsigned dependent = dependents[i][j];
+            if (--waiting[dependent] == 0)
+                pool.submit([&evaluate, dependent]() { evaluate(dependent); });
+        }
+    };
+
+    for (unsigned i = 0; i < objects.size(); ++i)
+        if ((!dirty || (*dirty)[i]) && waiting[i] == 0)
+            pool.submit([&evaluate, i]() { evaluate(i); });
+
+    pool.wait();
+
+    for (unsigned i = 0; i < objects.size(); ++i)
+        log << messages[i];
+}
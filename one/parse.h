@@ -3,8 +3,10 @@
 
 #include "curve.h"
 #include "surf.h"
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <vector>
 
 /* This function implements a parser for the "SWP" file format.  It's
    something Eugene came up with specifically for this assigment.
@@ -32,6 +34,29 @@
 
    NUMPOINTS indicates the number of control points.
 
+   Between STEPS and NUMPOINTS a curve may carry OPTION=VALUE tokens.
+   Giving a tolerance switches the curve to adaptive tessellation
+   (see CurveTolerance in curve.h), and STEPS is then only used to
+   report how many samples the fixed-step curve would have had:
+
+     tol=CHORD    maximum distance between the curve and its chords
+     angle=DEG    maximum turn of the tangent across one chord
+
+   For example "bsp2 profile 16 tol=0.001 angle=5 9".  Fixed-step
+   curves can instead spread their samples evenly along the curve
+   (see CurveSpacing in curve.h):
+
+     sampling=arclength   evenly spaced samples
+     sampling=uniform     uniform in t, the default
+
+   and any Bezier or B-spline curve can choose its coordinate frames,
+   which matter when it is used as a sweep:
+
+     frames=rmf           rotation minimizing frames, closed curves
+                          without a twist at the seam
+     frames=propagate     each frame derived from the previous
+                          binormal, the default
+
    Each CONTROLPOINT is given as [ x y ] for 2D curves, and [ x y z ]
    for 3D curves.  Note that the square braces are required.
 
@@ -59,14 +84,85 @@
    SWEEP is the name of a 2D *or* 3D curve.
 */
 
-// The vectors are passed in by reference.  parseFile actually writes
-// to these variables.  This is how we pull off a multiple
-// return-value function.
-bool parseFile(std::istream &in,
-               std::vector<std::vector<Vector3f> > &ctrlPoints, 
-               std::vector<Curve>                  &curves,     
-               std::vector<std::string>            &curveNames, 
-               std::vector<Surface>                &surfaces,   
-               std::vector<std::string>            &surfaceNames );
+// One object of a SWP file, as read but not yet evaluated.
+struct SwpObject
+{
+    SwpObject()
+        : steps(0), adaptive(false), spacing(PARAMETER_SPACING),
+          rotationMinimizing(false), radius(0), dim(0), index(0),
+          profile(0), sweep(0), fixedSize(0), fixedTriangles(0)
+    {
+        tolerance.chord = 0;
+        tolerance.angle = 0;
+    }
+
+    // Curves have a dimension of 2 or 3, surfaces of 0.
+    bool isCurve() const { return dim != 0; }
+
+    std::string type;          // bez2, bsp2, bez3, bsp3, circ, srev or gcyl
+    std::string name;          // "." for anonymous objects
+    unsigned steps;            // all but gcyl
+    CurveTolerance tolerance;  // Bezier and B-spline curves
+    bool adaptive;
+    CurveSpacing spacing;      // fixed-step Bezier and B-spline curves
+    bool rotationMinimizing;   // Bezier and B-spline curves
+    float radius;              // circ
+    std::vector<Vector3f> cps;
+    unsigned dim;
+
+    // Position among the curves, or among the surfaces, of the file.
+    unsigned index;
+
+    // Surfaces: the objects of the profile and (gcyl) sweep curves.
+    unsigned profile;
+    unsigned sweep;
+
+    // Sample count of a curve, and triangle count of a surface, with
+    // fixed-step curves.  Only used to report adaptive savings.
+    unsigned fixedSize;
+    unsigned fixedTriangles;
+};
+
+// Reads the objects of a SWP file without evaluating anything.  Names
+// are resolved and control point counts checked, so evaluating the
+// objects can't fail.  Progress and errors go to log.  Returns false
+// if the file is malformed.
+bool readSwpObjects(std::istream &in,
+                    std::vector<SwpObject> &objects,
+                    std::ostream &log = std::cerr);
+
+// Evaluates a curve object.
+Curve evalSwpCurve(const SwpObject &curve, std::ostream &log = std::cerr);
+
+// Builds a surface object.  objects is the whole file, and curves
+// holds its evaluated curves in file order.
+Surface makeSwpSurface(const SwpObject &surface,
+                       const std::vector<SwpObject> &objects,
+                       const std::vector<Curve> &curves,
+                       std::ostream &log = std::cerr);
+
+// Evaluates all the objects of a file into curves and surfaces, in
+// file order.  The objects form a graph in which surfaces depend on
+// their profile and sweep curves; every object is evaluated on a
+// thread pool as soon as the curves it needs are done, so independent
+// objects run concurrently.  threads == 0 means one thread per core.
+//
+// If dirty is given, only the objects flagged in it are evaluated,
+// and curves and surfaces must already be sized and hold the results
+// of all the other objects.  This is how a reload re-tessellates just
+// what changed.
+void evalSwpObjects(const std::vector<SwpObject> &objects,
+                    std::vector<Curve> &curves,
+                    std::vector<Surface> &surfaces,
+                    std::ostream &log = std::cerr,
+                    unsigned threads = 0,
+                    const std::vector<bool> *dirty = 0);
+
+// A hash of everything that determines the result of evaluating an
+// object: its type, steps, options and control points, and for a
+// surface the names of its curves.  Two objects with the same hash
+// (and curves that didn't change) evaluate to the same thing.
+uint64_t hashSwpObject(const SwpObject &object,
+                       const std::vector<SwpObject> &objects);
 
 #endif
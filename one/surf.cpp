@@ -1,5 +1,15 @@
 #include "surf.h"
-#include "extra.h"
+#include "ao.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+
 using namespace std;
 
 namespace
@@ -17,60 +27,257 @@ namespace
 
 		return true;
 	}
-}
 
-void addTriangles(Surface& surface, unsigned path_step, unsigned profile_step, unsigned profile_steps_number)
-{
-	Tup3u triangle;
+	// Whether a surface can wrap around the curve instead of storing
+	// its first point twice: the curve is closed, with the same frame
+	// at both ends.  Curves with a corner at the closing point keep
+	// both copies to get a crease there.
+	bool wrapsAround(const Curve& curve)
+	{
+		if (!closedCurve(curve))
+			return false;
 
-	triangle[0] = path_step * profile_steps_number + profile_step;
-	triangle[1] = (path_step - 1) * profile_steps_number + profile_step - 1;
-	triangle[2] = (path_step - 1) * profile_steps_number + profile_step;
-	surface.VF.push_back(triangle);
+		const CurvePoint& first = curve.front();
+		const CurvePoint& last = curve.back();
+		return sameCurveVector(first.N, last.N) && sameCurveVector(first.B, last.B);
+	}
 
-	triangle[1] = path_step * profile_steps_number + profile_step - 1;
-	triangle[2] = (path_step - 1) * profile_steps_number + profile_step - 1;
-	surface.VF.push_back(triangle);
-}
+	// Surfaces are only built in parallel when each thread gets at least
+	// this many vertices.
+	const unsigned kParallelSurfaceVertices = 16384;
 
-Surface makeSurfRev(const Curve& profile, unsigned steps)
-{
-	Surface surface;
+	// The profile vertices and normals as packed arrays.  They are
+	// gathered once per surface, so that each ring is two batch
+	// transforms writing straight into the preallocated vertex and normal
+	// arrays of the ring.
+	struct ProfileArrays
+	{
+		explicit ProfileArrays(const Curve& profile)
+			: V(profile.size()), N(profile.size())
+		{
+			for (size_t i = 0; i < profile.size(); ++i)
+			{
+				V[i] = profile[i].V;
+				N[i] = profile[i].N;
+			}
+		}
 
-	if (!checkFlat(profile))
+		vector<Vector3f> V;
+		vector<Vector3f> N;
+	};
+
+	// Rotates profile points [first, end) by R.
+	void transformRing(const Matrix3f& R, const ProfileArrays& profile, unsigned first, unsigned end, Vector3f* VV, Vector3f* VN)
 	{
-		cerr << "surfRev profile curve must be flat on xy plane." << endl;
-		exit(0);
+		transformVectors(R, profile.V.data() + first, VV + first, end - first);
+		transformVectors(R, profile.N.data() + first, VN + first, end - first);
+	}
+
+	// Transforms profile points [first, end) by the affine frame M, and
+	// the normals by its upper 3x3 part (M is a rigid frame, so that is
+	// its own inverse transpose).
+	void transformRing(const Matrix4f& M, const ProfileArrays& profile, unsigned first, unsigned end, Vector3f* VV, Vector3f* VN)
+	{
+		transformPoints(M, profile.V.data() + first, VV + first, end - first);
+		transformVectors(M, profile.N.data() + first, VN + first, end - first);
 	}
 
-	for (unsigned surf_rotation_step = 0; surf_rotation_step <= steps; ++surf_rotation_step)
+	// The rotation of ring surf_rotation_step of a surface of revolution.
+	Matrix3f revolutionFrame(unsigned surf_rotation_step, unsigned steps)
 	{
 		// step from 0 to 2pi
 		float rotation = 2.0f * M_PI * float(surf_rotation_step) / steps;
-		Matrix3f rotation_matrix = Matrix3f::rotation(Vector3f::UP, rotation);
+		return Matrix3f::rotation(Vector3f::UP, rotation);
+	}
+
+	// The frame of a generalized cylinder ring at a sweep point.
+	Matrix4f sweepFrame(const CurvePoint& sweep_pt)
+	{
+		Matrix4f position_transform = Matrix4f::identity();
+		position_transform.setCol(0, Vector4f(sweep_pt.N, 0.0f));
+		position_transform.setCol(1, Vector4f(sweep_pt.B, 0.0f));
+		position_transform.setCol(2, Vector4f(sweep_pt.T, 0.0f));
+		position_transform.setCol(3, Vector4f(sweep_pt.V, 1.0f));
+		return position_transform;
+	}
+
+	// The vertex grid of a swept surface: rings copies of the profile,
+	// with columns vertices each.  A closed profile or sweep is welded at
+	// its seam: its last point is not stored again, and the last column
+	// or ring of cells wraps around to column or ring 0.
+	struct SurfaceGrid
+	{
+		unsigned columns;
+		unsigned rings;
+		bool closedProfile;
+		bool closedSweep;
 
-		for (unsigned curve_pt_index = 0; curve_pt_index < profile.size(); ++curve_pt_index)
+		unsigned columnCells() const
 		{
-			//vertex
-			surface.VV.push_back(rotation_matrix * profile[curve_pt_index].V);
+			return closedProfile ? columns : max(columns, 1u) - 1;
+		}
 
-			//normal (assume normals will always point to the left of the direction of travel)
-			//Vector3f normal = Vector3f::cross(profile[curve_pt_index].T, -Vector3f::FORWARD);
+		unsigned ringCells() const
+		{
+			return closedSweep ? rings : max(rings, 1u) - 1;
+		}
+	};
 
-			//INTERESTING FACT: If a point is transformed by matrix M (INCLUDING NON-UNIFORM SCALING OR SHEAR),
-			//the correct way to transform a normal vector is by using the inverse transpose of the upper-left 3x3 part of M.
-			//SO IT IS MORE GENERAL WAY TRANSFORM NORMALS, BUT WE DON'T NEED IT HERE
+	// A full revolution always closes, except for degenerate step counts.
+	SurfaceGrid surfRevGrid(const Curve& profile, unsigned steps)
+	{
+		SurfaceGrid grid;
+		grid.closedProfile = wrapsAround(profile);
+		grid.closedSweep = steps > 1;
+		grid.columns = unsigned(profile.size()) - (grid.closedProfile ? 1 : 0);
+		grid.rings = grid.closedSweep ? steps : steps + 1;
+		return grid;
+	}
 
-			surface.VN.push_back(rotation_matrix * profile[curve_pt_index].N);
+	SurfaceGrid genCylGrid(const Curve& profile, const Curve& sweep)
+	{
+		SurfaceGrid grid;
+		grid.closedProfile = wrapsAround(profile);
+		grid.closedSweep = wrapsAround(sweep);
+		grid.columns = unsigned(profile.size()) - (grid.closedProfile ? 1 : 0);
+		grid.rings = unsigned(sweep.size()) - (grid.closedSweep ? 1 : 0);
+		return grid;
+	}
 
-			if (surf_rotation_step > 0 && curve_pt_index > 0)
+	// Sizes the vertices and normals of the surface for the grid.
+	void allocateSurface(Surface& surface, const SurfaceGrid& grid)
+	{
+		surface.VV.resize(grid.columns * grid.rings);
+		surface.VN.resize(grid.columns * grid.rings);
+	}
+
+	// Writes the two triangles of every cell between ring cell and the
+	// next one.  Cells are stored ring by ring, so each ring owns a
+	// disjoint range of the faces.
+	void addTriangles(Tup3u* faces, const SurfaceGrid& grid, unsigned cell)
+	{
+		unsigned columns = grid.columns;
+		unsigned previous = cell * columns;
+		unsigned current = (cell + 1 == grid.rings ? 0 : cell + 1) * columns;
+
+		Tup3u* triangle = &faces[2 * cell * grid.columnCells()];
+
+		for (unsigned profile_step = 1; profile_step <= grid.columnCells(); ++profile_step)
+		{
+			unsigned column = profile_step == columns ? 0 : profile_step;
+
+			triangle[0][0] = current + column;
+			triangle[0][1] = previous + profile_step - 1;
+			triangle[0][2] = previous + column;
+
+			triangle[1][0] = current + column;
+			triangle[1][1] = current + profile_step - 1;
+			triangle[1][2] = previous + profile_step - 1;
+
+			triangle += 2;
+		}
+	}
+
+	struct GridKey
+	{
+		unsigned columns;
+		unsigned rings;
+		bool closedProfile;
+		bool closedSweep;
+
+		bool operator<(const GridKey& other) const
+		{
+			if (columns != other.columns)
+				return columns < other.columns;
+			if (rings != other.rings)
+				return rings < other.rings;
+			if (closedProfile != other.closedProfile)
+				return closedProfile < other.closedProfile;
+			return closedSweep < other.closedSweep;
+		}
+	};
+
+	typedef shared_ptr< const vector<Tup3u> > FacesPointer;
+
+	// The face arrays in use, by grid shape.  The cache doesn't keep
+	// them alive: an array goes away with the last surface using it,
+	// and its entry is dropped on the next miss.
+	mutex gridFacesMutex;
+	map< GridKey, weak_ptr< const vector<Tup3u> > > gridFacesCache;
+
+	// The faces of a grid, from the cache or built in parallel.  Surfaces
+	// are built concurrently, so two threads may build the same faces at
+	// once; the first one to finish gets to cache them.
+	SharedFaces gridFaces(const SurfaceGrid& grid)
+	{
+		GridKey key = { grid.columns, grid.rings, grid.closedProfile, grid.closedSweep };
+
+		{
+			lock_guard<mutex> lock(gridFacesMutex);
+			FacesPointer cached = gridFacesCache[key].lock();
+			if (cached)
+				return SharedFaces(cached);
+		}
+
+		shared_ptr< vector<Tup3u> > faces = make_shared< vector<Tup3u> >(2 * grid.columnCells() * grid.ringCells());
+
+		if (!faces->empty())
+		{
+			parallelFor(0, grid.ringCells(), kParallelSurfaceVertices / max(grid.columns, 1u), [&](size_t cell)
 			{
-				//triangles
-				addTriangles(surface, surf_rotation_step, curve_pt_index, profile.size());
-			}
+				addTriangles(&(*faces)[0], grid, cell);
+			});
+		}
+
+		lock_guard<mutex> lock(gridFacesMutex);
+
+		for (auto it = gridFacesCache.begin(); it != gridFacesCache.end(); )
+		{
+			if (it->second.expired())
+				it = gridFacesCache.erase(it);
+			else
+				++it;
 		}
 
+		FacesPointer cached = gridFacesCache[key].lock();
+		if (!cached)
+		{
+			cached = faces;
+			gridFacesCache[key] = cached;
+		}
+		return SharedFaces(cached);
 	}
+}
+
+Surface makeSurfRev(const Curve& profile, unsigned steps)
+{
+	Surface surface;
+
+	if (!checkFlat(profile))
+	{
+		cerr << "surfRev profile curve must be flat on xy plane." << endl;
+		exit(0);
+	}
+
+	SurfaceGrid grid = surfRevGrid(profile, steps);
+	allocateSurface(surface, grid);
+	ProfileArrays profileArrays(profile);
+
+	//normal (assume normals will always point to the left of the direction of travel)
+	//Vector3f normal = Vector3f::cross(profile[curve_pt_index].T, -Vector3f::FORWARD);
+
+	//INTERESTING FACT: If a point is transformed by matrix M (INCLUDING NON-UNIFORM SCALING OR SHEAR),
+	//the correct way to transform a normal vector is by using the inverse transpose of the upper-left 3x3 part of M.
+	//SO IT IS MORE GENERAL WAY TRANSFORM NORMALS, BUT WE DON'T NEED IT HERE
+
+	parallelFor(0, grid.rings, kParallelSurfaceVertices / max(grid.columns, 1u), [&](size_t surf_rotation_step)
+	{
+		transformRing(revolutionFrame(surf_rotation_step, steps), profileArrays, 0, grid.columns,
+			&surface.VV[surf_rotation_step * grid.columns], &surface.VN[surf_rotation_step * grid.columns]);
+	});
+
+	//triangles
+	surface.VF = gridFaces(grid);
 
 	return surface;
 }
@@ -85,127 +292,325 @@ Surface makeGenCyl(const Curve& profile, const Curve& sweep)
 		exit(0);
 	}
 
-	for (unsigned sweep_step = 0; sweep_step < sweep.size(); ++sweep_step)
+	SurfaceGrid grid = genCylGrid(profile, sweep);
+	allocateSurface(surface, grid);
+	ProfileArrays profileArrays(profile);
+
+	parallelFor(0, grid.rings, kParallelSurfaceVertices / max(grid.columns, 1u), [&](size_t sweep_step)
 	{
-		const CurvePoint& sweep_pt = sweep[sweep_step];
-		Matrix4f position_transform = Matrix4f::identity();
-		position_transform.setCol(0, Vector4f(sweep_pt.N, 0.0f));
-		position_transform.setCol(1, Vector4f(sweep_pt.B, 0.0f));
-		position_transform.setCol(2, Vector4f(sweep_pt.T, 0.0f));
-		position_transform.setCol(3, Vector4f(sweep_pt.V, 1.0f));
+		//normal.negate();//if profile is circle need to negate for proper render
+		transformRing(sweepFrame(sweep[sweep_step]), profileArrays, 0, grid.columns,
+			&surface.VV[sweep_step * grid.columns], &surface.VN[sweep_step * grid.columns]);
+	});
 
-		Matrix3f normal_transform = position_transform.getSubmatrix3x3(0,0);
+	//triangles
+	surface.VF = gridFaces(grid);
 
-		for (unsigned profile_step = 0; profile_step < profile.size(); ++profile_step)
-		{
-			//vertex
-			Vector4f pos(profile[profile_step].V, 1.0f);
-			pos = position_transform * pos;
-			surface.VV.push_back(pos.xyz());
+	return surface;
+}
 
-			//normal
-			Vector3f normal = normal_transform * profile[profile_step].N;
-			//normal.negate();//if profile is circle need to negate for proper render
-			surface.VN.push_back(normal);
+namespace
+{
+	// Recomputes profile points [change.first, change.end) of a ring.
+	// The last point of a closed profile is column 0, which is redone
+	// from the first point when it changed.
+	template <typename Frame>
+	void updateRing(const Frame& frame, const ProfileArrays& profile, const SurfaceGrid& grid, const CurveChange& change,
+		Vector3f* VV, Vector3f* VN)
+	{
+		transformRing(frame, profile, change.first, min(change.end, grid.columns), VV, VN);
 
-			if (sweep_step > 0 && profile_step > 0)
-			{
-				//triangles
-				addTriangles(surface, sweep_step, profile_step, profile.size());
-			}
-		}
+		if (grid.closedProfile && change.end > grid.columns && change.first > 0)
+			transformRing(frame, profile, 0, 1, VV, VN);
 	}
-
-	return surface;
 }
 
-void drawSurface(const Surface& surface, bool shaded)
+void updateSurfRevProfile(Surface& surface, const Curve& profile, unsigned steps, const CurveChange& change)
 {
-	// Save current state of OpenGL
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	// The edit opened or closed the profile
+	SurfaceGrid grid = surfRevGrid(profile, steps);
+	if (surface.VV.size() != size_t(grid.columns) * grid.rings)
+	{
+		surface = makeSurfRev(profile, steps);
+		return;
+	}
+
+	// The baked occlusion no longer matches the moved vertices
+	surface.AO.clear();
+
+	ProfileArrays profileArrays(profile);
 
-	if (shaded)
+	parallelFor(0, grid.rings, kParallelSurfaceVertices / max(change.end - change.first, 1u), [&](size_t surf_rotation_step)
 	{
-		// This will use the current material color and light
-		// positions.  Just set these in drawScene();
-		glEnable(GL_LIGHTING);
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		updateRing(revolutionFrame(surf_rotation_step, steps), profileArrays, grid, change,
+			&surface.VV[surf_rotation_step * grid.columns], &surface.VN[surf_rotation_step * grid.columns]);
+	});
+}
 
-		// This tells openGL to *not* draw backwards-facing triangles.
-		// This is more efficient, and in addition it will help you
-		// make sure that your triangles are drawn in the right order.
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
+void updateGenCylProfile(Surface& surface, const Curve& profile, const Curve& sweep, const CurveChange& change)
+{
+	SurfaceGrid grid = genCylGrid(profile, sweep);
+	if (surface.VV.size() != size_t(grid.columns) * grid.rings)
+	{
+		surface = makeGenCyl(profile, sweep);
+		return;
 	}
-	else
+
+	// The baked occlusion no longer matches the moved vertices
+	surface.AO.clear();
+
+	ProfileArrays profileArrays(profile);
+
+	parallelFor(0, grid.rings, kParallelSurfaceVertices / max(change.end - change.first, 1u), [&](size_t sweep_step)
 	{
-		glDisable(GL_LIGHTING);
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+		updateRing(sweepFrame(sweep[sweep_step]), profileArrays, grid, change,
+			&surface.VV[sweep_step * grid.columns], &surface.VN[sweep_step * grid.columns]);
+	});
+}
 
-		glColor4f(0.4f, 0.4f, 0.4f, 1.f);
-		glLineWidth(1);
+void updateGenCylSweep(Surface& surface, const Curve& profile, const Curve& sweep, const CurveChange& change)
+{
+	SurfaceGrid grid = genCylGrid(profile, sweep);
+	if (surface.VV.size() != size_t(grid.columns) * grid.rings)
+	{
+		surface = makeGenCyl(profile, sweep);
+		return;
 	}
 
-	glBegin(GL_TRIANGLES);
-	for (unsigned i = 0; i < surface.VF.size(); i++)
+	// The baked occlusion no longer matches the moved vertices
+	surface.AO.clear();
+
+	ProfileArrays profileArrays(profile);
+	unsigned end = min(change.end, grid.rings);
+
+	parallelFor(change.first, end, kParallelSurfaceVertices / max(grid.columns, 1u), [&](size_t sweep_step)
 	{
-		glNormal(surface.VN[surface.VF[i][0]]);
-		glVertex(surface.VV[surface.VF[i][0]]);
-		glNormal(surface.VN[surface.VF[i][1]]);
-		glVertex(surface.VV[surface.VF[i][1]]);
-		glNormal(surface.VN[surface.VF[i][2]]);
-		glVertex(surface.VV[surface.VF[i][2]]);
-	}
-	glEnd();
+		transformRing(sweepFrame(sweep[sweep_step]), profileArrays, 0, grid.columns,
+			&surface.VV[sweep_step * grid.columns], &surface.VN[sweep_step * grid.columns]);
+	});
 
-	glPopAttrib();
+	// The last point of a closed sweep is ring 0
+	if (grid.closedSweep && change.end > grid.rings && change.first > 0)
+		transformRing(sweepFrame(sweep[0]), profileArrays, 0, grid.columns, &surface.VV[0], &surface.VN[0]);
 }
 
-void drawNormals(const Surface& surface, float len)
+namespace
 {
-	// Save current state of OpenGL
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
+	// The exporters format this many vertices or faces at a time into
+	// a chunk buffer, and write each chunk with a single call.
+	const size_t kExportChunkItems = 16384;
 
-	glDisable(GL_LIGHTING);
-	glColor4f(0, 1, 1, 1);
-	glLineWidth(1);
+	// Upper bounds on the formatted length of the numbers, see
+	// writeFloat and writeUnsigned.
+	const size_t kMaxFloatChars = 16;
+	const size_t kMaxUnsignedChars = 10;
 
-	glBegin(GL_LINES);
-	for (unsigned i = 0; i < surface.VV.size(); i++)
+	// Formats x like printf's %g, which is what ostreams do by default.
+	char* writeFloat(char* p, float x)
 	{
-		glVertex(surface.VV[i]);
-		glVertex(surface.VV[i] + surface.VN[i] * len);
+		return to_chars(p, p + kMaxFloatChars, x, chars_format::general, 6).ptr;
 	}
-	glEnd();
 
-	glPopAttrib();
+	char* writeUnsigned(char* p, unsigned x)
+	{
+		return to_chars(p, p + kMaxUnsignedChars, x).ptr;
+	}
+
+	// Stores x in little-endian byte order, whatever the host order.
+	char* writeLittleEndian(char* p, uint32_t x)
+	{
+		p[0] = char(x);
+		p[1] = char(x >> 8);
+		p[2] = char(x >> 16);
+		p[3] = char(x >> 24);
+		return p + 4;
+	}
+
+	char* writeLittleEndian(char* p, float x)
+	{
+		uint32_t bits;
+		memcpy(&bits, &x, sizeof(bits));
+		return writeLittleEndian(p, bits);
+	}
+
+	// Writes sections of a file through a few large buffers that are
+	// allocated once and reused.  Each section is cut into chunks that
+	// are formatted in parallel, one chunk per thread, and then written
+	// in order, so the output doesn't depend on the number of threads.
+	class ChunkWriter
+	{
+	public:
+		explicit ChunkWriter(ostream& out)
+			: out(out),
+			  buffers(max(1u, thread::hardware_concurrency())),
+			  sizes(buffers.size())
+		{
+		}
+
+		void write(const char* text)
+		{
+			out << text;
+		}
+
+		// Writes count items.  format(p, i) writes item i, at most
+		// maxItemChars characters, starting at p and returns its end.
+		template <typename Format>
+		void write(size_t count, size_t maxItemChars, const Format& format)
+		{
+			size_t perRound = kExportChunkItems * buffers.size();
+			for (size_t first = 0; first < count; first += perRound)
+			{
+				size_t chunks = (min(count - first, perRound) + kExportChunkItems - 1) / kExportChunkItems;
+
+				parallelFor(0, chunks, 1, [&](size_t c)
+				{
+					size_t begin = first + c * kExportChunkItems;
+					size_t end = min(count, begin + kExportChunkItems);
+
+					// Only grows on the first use of the buffer
+					if (buffers[c].size() < kExportChunkItems * maxItemChars)
+						buffers[c].resize(kExportChunkItems * maxItemChars);
+
+					char* start = &buffers[c][0];
+					char* p = start;
+					for (size_t i = begin; i < end; ++i)
+						p = format(p, i);
+					sizes[c] = p - start;
+				});
+
+				for (size_t c = 0; c < chunks; ++c)
+					out.write(&buffers[c][0], sizes[c]);
+			}
+		}
+
+	private:
+		ostream& out;
+		vector< vector<char> > buffers;
+		vector<size_t> sizes;
+	};
+
+	char* writeVector(char* p, const char* tag, size_t tagLength, const Vector3f& v)
+	{
+		memcpy(p, tag, tagLength);
+		p += tagLength;
+		p = writeFloat(p, v[0]);
+		*p++ = ' ';
+		p = writeFloat(p, v[1]);
+		*p++ = ' ';
+		p = writeFloat(p, v[2]);
+		*p++ = '\n';
+		return p;
+	}
 }
 
 void outputObjFile(ostream& out, const Surface& surface)
 {
+	ChunkWriter writer(out);
+	const size_t maxVectorChars = 3 + 3 * (kMaxFloatChars + 1);
+	const size_t maxFaceChars = 3 + 3 * (2 * kMaxUnsignedChars + 4) + 1;
 
-	for (unsigned i = 0; i < surface.VV.size(); i++)
-		out << "v  "
-		<< surface.VV[i][0] << " "
-		<< surface.VV[i][1] << " "
-		<< surface.VV[i][2] << endl;
+	writer.write(surface.VV.size(), maxVectorChars, [&](char* p, size_t i)
+	{
+		return writeVector(p, "v  ", 3, surface.VV[i]);
+	});
 
-	for (unsigned i = 0; i < surface.VN.size(); i++)
-		out << "vn "
-		<< surface.VN[i][0] << " "
-		<< surface.VN[i][1] << " "
-		<< surface.VN[i][2] << endl;
+	writer.write(surface.VN.size(), maxVectorChars, [&](char* p, size_t i)
+	{
+		return writeVector(p, "vn ", 3, surface.VN[i]);
+	});
 
-	out << "vt  0 0 0" << endl;
+	writer.write("vt  0 0 0\n");
 
-	for (unsigned i = 0; i < surface.VF.size(); i++)
+	writer.write(surface.VF.size(), maxFaceChars, [&](char* p, size_t i)
 	{
-		out << "f  ";
+		memcpy(p, "f  ", 3);
+		p += 3;
 		for (unsigned j = 0; j < 3; j++)
 		{
 			unsigned a = surface.VF[i][j] + 1;
-			out << a << "/" << "1" << "/" << a << " ";
+			p = writeUnsigned(p, a);
+			memcpy(p, "/1/", 3);
+			p = writeUnsigned(p + 3, a);
+			*p++ = ' ';
 		}
-		out << endl;
+		*p++ = '\n';
+		return p;
+	});
+}
+
+void outputPlyFile(ostream& out, const Surface& surface, bool binary)
+{
+	ChunkWriter writer(out);
+
+	out << "ply\n"
+		<< (binary ? "format binary_little_endian 1.0\n" : "format ascii 1.0\n")
+		<< "element vertex " << surface.VV.size() << "\n"
+		<< "property float x\n"
+		<< "property float y\n"
+		<< "property float z\n"
+		<< "property float nx\n"
+		<< "property float ny\n"
+		<< "property float nz\n"
+		<< "element face " << surface.VF.size() << "\n"
+		<< "property list uchar uint vertex_indices\n"
+		<< "end_header\n";
+
+	if (binary)
+	{
+		writer.write(surface.VV.size(), 6 * sizeof(float), [&](char* p, size_t i)
+		{
+			for (unsigned j = 0; j < 3; j++)
+				p = writeLittleEndian(p, surface.VV[i][j]);
+			for (unsigned j = 0; j < 3; j++)
+				p = writeLittleEndian(p, surface.VN[i][j]);
+			return p;
+		});
+
+		writer.write(surface.VF.size(), 1 + 3 * sizeof(uint32_t), [&](char* p, size_t i)
+		{
+			*p++ = 3;
+			for (unsigned j = 0; j < 3; j++)
+				p = writeLittleEndian(p, uint32_t(surface.VF[i][j]));
+			return p;
+		});
 	}
+	else
+	{
+		writer.write(surface.VV.size(), 6 * (kMaxFloatChars + 1), [&](char* p, size_t i)
+		{
+			for (unsigned j = 0; j < 3; j++)
+			{
+				p = writeFloat(p, surface.VV[i][j]);
+				*p++ = ' ';
+			}
+			for (unsigned j = 0; j < 3; j++)
+			{
+				p = writeFloat(p, surface.VN[i][j]);
+				*p++ = j < 2 ? ' ' : '\n';
+			}
+			return p;
+		});
+
+		writer.write(surface.VF.size(), 2 + 3 * (kMaxUnsignedChars + 1), [&](char* p, size_t i)
+		{
+			*p++ = '3';
+			for (unsigned j = 0; j < 3; j++)
+			{
+				*p++ = ' ';
+				p = writeUnsigned(p, surface.VF[i][j]);
+			}
+			*p++ = '\n';
+			return p;
+		});
+	}
+}
+
+void bakeSurfaceAO(Surface& surface, const string& cacheFile)
+{
+	// Tup3u is three packed unsigneds, so the faces copy in one go
+	vector<unsigned> indices(3 * surface.VF.size());
+	if (!surface.VF.empty())
+		memcpy(&indices[0], surface.VF.data(), surface.VF.size() * sizeof(Tup3u));
+
+	bakeAmbientOcclusionCached(cacheFile, surface.VV, surface.VN, indices, surface.AO);
 }
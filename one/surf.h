@@ -5,29 +5,61 @@
 #include "tuple.h"
 
 #include <iostream>
+#include <memory>
+#include <string>
 
 // Tup3u is a handy shortcut for an array of 3 unsigned integers.  You
 // can access elements using [], and you can copy using =, and so on.
+// An array of them is a plain array of 3 * n unsigneds (see tuple.h).
 typedef tuple< unsigned, 3 > Tup3u;
 
+// A read-only, reference counted array of faces.  The faces of a
+// swept surface only depend on the size and closure of its grid, so
+// makeSurfRev and makeGenCyl hand out one shared array per grid shape
+// for as long as some surface uses it.  Copying a SharedFaces (or a
+// Surface) shares the array instead of copying it.
+class SharedFaces
+{
+public:
+    SharedFaces() {}
+
+    explicit SharedFaces( std::shared_ptr< const std::vector< Tup3u > > faces )
+        : faces( faces )
+    {
+    }
+
+    size_t size() const { return faces ? faces->size() : 0; }
+    bool empty() const { return size() == 0; }
+
+    const Tup3u& operator[]( size_t i ) const { return ( *faces )[ i ]; }
+
+    // The faces, contiguous, or 0 if there are none
+    const Tup3u* data() const { return empty() ? 0 : &( *faces )[ 0 ]; }
+    const Tup3u* begin() const { return data(); }
+    const Tup3u* end() const { return data() + size(); }
+
+    // Number of SharedFaces using the array
+    long useCount() const { return faces.use_count(); }
+
+private:
+    std::shared_ptr< const std::vector< Tup3u > > faces;
+};
+
 // Surface is just a struct that contains vertices, normals, and
 // faces.  VV[i] is the position of vertex i, and VN[i] is the normal
 // of vertex i.  A face is a triple i,j,k corresponding to a triangle
-// with (vertex i, normal i), (vertex j, normal j), ...
+// with (vertex i, normal i), (vertex j, normal j), ...  The faces are
+// shared with other surfaces of the same grid shape.  AO[i] is the
+// baked ambient occlusion of vertex i; it stays empty until
+// bakeSurfaceAO is called.
 struct Surface
 {
     std::vector< Vector3f > VV;
     std::vector< Vector3f > VN;
-    std::vector< Tup3u > VF;
+    SharedFaces VF;
+    std::vector< float > AO;
 };
 
-// This draws the surface.  Draws the surfaces with smooth shading if
-// shaded==true, otherwise, draws a wireframe.
-void drawSurface( const Surface& surface, bool shaded );
-
-// This draws normals to the surface at each vertex of length len.
-void drawNormals( const Surface& surface, float len );
-
 // Sweep a profile curve that lies flat on the xy-plane around the
 // y-axis.  The number of divisions is given by steps.
 Surface makeSurfRev( const Curve& profile, unsigned steps );
@@ -35,8 +67,42 @@ Surface makeSurfRev( const Curve& profile, unsigned steps );
 Surface makeGenCyl( const Curve& profile,
                     const Curve& sweep );
 
+// Both builders weld the seams of closed curves: when the last point
+// of the profile or sweep repeats the first one (with the same
+// frame), it is not stored again and the faces wrap around to the
+// first column or ring.  A full revolution is always closed.  The
+// meshes of closed curves are watertight, and the face count is the
+// same as without welding.
+
+// Patch a surface after one of its curves changed (see
+// EditableBspline in curve.h).  Only the vertices and normals built
+// from the changed curve points are recomputed, in place: a changed
+// profile touches those columns of every ring, a changed sweep just
+// those rings.  The curves must keep their number of points, so the
+// faces stay valid; if an edit opens or closes a curve, the surface
+// is rebuilt.  Either way the baked AO is dropped, since it was cast
+// from the old shape; it is left empty until bakeSurfaceAO runs again.
+void updateSurfRevProfile( Surface& surface, const Curve& profile, unsigned steps,
+                           const CurveChange& change );
+void updateGenCylProfile( Surface& surface, const Curve& profile, const Curve& sweep,
+                          const CurveChange& change );
+void updateGenCylSweep( Surface& surface, const Curve& profile, const Curve& sweep,
+                        const CurveChange& change );
+
+// Writes the surface as a Wavefront OBJ file.  The text is formatted
+// into large buffers, in parallel for big surfaces, and written in a
+// few big chunks.
 void outputObjFile( std::ostream& out, const Surface& surface );
 
+// Writes the surface as a PLY file with per-vertex normals.  If
+// binary==true the data is binary little-endian; out must then be
+// opened in binary mode.
+void outputPlyFile( std::ostream& out, const Surface& surface, bool binary = true );
+
+// Fills surface.AO by ray casting (see ao.h).  The result is cached
+// in cacheFile and reused as long as the surface doesn't change.
+void bakeSurfaceAO( Surface& surface, const std::string& cacheFile );
+
 
 
 
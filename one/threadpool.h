@@ -0,0 +1,104 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+
+// A fixed set of worker threads running queued tasks.  Tasks may
+// submit more tasks; wait() returns once the queue is empty and no
+// task is running any more.  A parallelFor inside a task runs on the
+// task's thread, so a pool of N threads never has more than N busy.
+class ThreadPool
+{
+public:
+	// threads == 0 means one worker per hardware thread.
+	explicit ThreadPool(unsigned threads = 0)
+		: pending(0), stopping(false)
+	{
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		for (unsigned i = 0; i < threads; ++i)
+			workers.push_back(std::thread([this]() { work(); }));
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		taskReady.notify_all();
+
+		for (size_t i = 0; i < workers.size(); ++i)
+			workers[i].join();
+	}
+
+	unsigned size() const
+	{
+		return unsigned(workers.size());
+	}
+
+	void submit(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(std::move(task));
+			++pending;
+		}
+		taskReady.notify_one();
+	}
+
+	void wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		allDone.wait(lock, [this]() { return pending == 0; });
+	}
+
+private:
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+	void work()
+	{
+		ParallelWorkScope scope;
+		for (;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				taskReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+				if (tasks.empty())
+					return;
+
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+
+			task();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--pending == 0)
+				allDone.notify_all();
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::deque< std::function<void()> > tasks;
+	std::mutex mutex;
+	std::condition_variable taskReady;
+	std::condition_variable allDone;
+
+	// Tasks queued or running
+	size_t pending;
+	bool stopping;
+};
+
+#endif
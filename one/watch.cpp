@@ -0,0 +1,84 @@
+#include "watch.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+FileWatcher::FileWatcher(const string& path)
+	: path(path), fd(-1), lastTime(0), lastSize(-1)
+{
+	string::size_type slash = path.find_last_of("/\\");
+	string directory = (slash == string::npos) ? "." : path.substr(0, slash + 1);
+	name = (slash == string::npos) ? path : path.substr(slash + 1);
+
+#ifdef __linux__
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd >= 0 && inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		close(fd);
+		fd = -1;
+	}
+#else
+	(void)directory;
+#endif
+
+	// Remember the current state for polling
+	pollChanged();
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (fd >= 0)
+		close(fd);
+#endif
+}
+
+bool FileWatcher::changed()
+{
+#ifdef __linux__
+	if (fd >= 0)
+	{
+		bool seen = false;
+
+		// Drain all pending events, looking for our file
+		char buffer[4096] __attribute__((aligned(__alignof__(inotify_event))));
+		ssize_t length;
+		while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+		{
+			for (char* p = buffer; p < buffer + length; )
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+				if (event->len > 0 && name == event->name)
+					seen = true;
+				p += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		return seen;
+	}
+#endif
+
+	return pollChanged();
+}
+
+bool FileWatcher::pollChanged()
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return false;
+
+	// The first poll only records the state
+	bool first = lastSize < 0;
+	bool changed = info.st_mtime != lastTime || info.st_size != lastSize;
+	lastTime = info.st_mtime;
+	lastSize = info.st_size;
+
+	return changed && !first;
+}
@@ -0,0 +1,39 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <ctime>
+#include <string>
+
+// Tells when a file has been written.  On Linux this uses inotify on
+// the directory of the file, so editors that save by renaming a new
+// file over the old one are caught as well.  Only finished writes
+// count (IN_CLOSE_WRITE and IN_MOVED_TO): a file that was just created
+// may not have any content yet.  Elsewhere (or if inotify isn't
+// available) the modification time and size are polled.
+class FileWatcher
+{
+public:
+	explicit FileWatcher(const std::string& path);
+	~FileWatcher();
+
+	// True if the file changed since the last call.  Never blocks, so
+	// it can be called from a timer.
+	bool changed();
+
+private:
+	FileWatcher(const FileWatcher&);
+	FileWatcher& operator=(const FileWatcher&);
+
+	bool pollChanged();
+
+	std::string path;
+	std::string name;
+
+	// inotify descriptor, or -1 when polling
+	int fd;
+
+	time_t lastTime;
+	long long lastSize;
+};
+
+#endif
@@ -1 +1,8 @@
 #include "Joint.h"
+
+Matrix4f Joint::transform() const
+{
+	Matrix4f m = Matrix4f::rotation(rotation);
+	m.setCol(3, Vector4f(translation, 1));
+	return m;
+}
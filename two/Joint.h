@@ -6,7 +6,13 @@
 
 struct Joint
 {
-	Matrix4f transform; // transform relative to its parent
+	// The pose relative to the parent: a rotation, then a translation.
+	// Slider updates only touch the rotation; the matrix is built by
+	// transform() when a chain of transforms is composed.
+	Quat4f rotation = Quat4f::IDENTITY;
+	Vector3f translation;
+
+	Matrix4f transform() const; // transform relative to its parent
 	std::vector< Joint* > children; // list of children
 
 	// This matrix transforms world space into joint space for the initial ("bind") configuration of the joints.
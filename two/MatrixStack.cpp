@@ -1,6 +1,10 @@
 #include "MatrixStack.h"
 
-MatrixStack::MatrixStack() : m_matrices(1)
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+MatrixStack::MatrixStack() : m_size(1)
 {
 	// Initialize the matrix stack with the identity matrix.
 	m_matrices[0] = Matrix4f::identity();
@@ -9,14 +13,15 @@ MatrixStack::MatrixStack() : m_matrices(1)
 void MatrixStack::clear()
 {
 	// Revert to just containing the identity matrix.
-	m_matrices.clear();
-	m_matrices.push_back(Matrix4f::identity());
+	m_size = 1;
+	m_matrices[0] = Matrix4f::identity();
 }
 
-Matrix4f MatrixStack::top()
+const Matrix4f& MatrixStack::top() const
 {
 	// Return the top of the stack
-	return m_matrices.back();
+	assert(m_size > 0);
+	return m_matrices[m_size - 1];
 }
 
 void MatrixStack::push(const Matrix4f& m)
@@ -24,11 +29,29 @@ void MatrixStack::push(const Matrix4f& m)
 	// Push m onto the stack.
 	// Your stack should have OpenGL semantics:
 	// the new top should be the old top multiplied by m
-	m_matrices.push_back(top() * m);
+
+	// The array can't grow, so a skeleton deeper than MAX_DEPTH joints
+	// has to stop here even in release builds.
+	if (m_size >= MAX_DEPTH)
+	{
+		std::cerr << "Error: MatrixStack overflow, more than " << MAX_DEPTH << " matrices\n";
+		std::abort();
+	}
+
+	// The joint transforms are affine, but the full 4x4 product is used:
+	// it has a SIMD kernel, and the 3x4 Affine3f product doesn't.
+	m_matrices[m_size] = m_matrices[m_size - 1] * m;
+	++m_size;
 }
 
 void MatrixStack::pop()
 {
-	// Remove the top element from the stack
-	m_matrices.pop_back();
+	// Remove the top element from the stack.  The identity at the
+	// bottom stays, so an unbalanced pop is an error.
+	if (m_size <= 1)
+	{
+		std::cerr << "Error: MatrixStack underflow\n";
+		std::abort();
+	}
+	--m_size;
 }
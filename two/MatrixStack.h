@@ -1,21 +1,27 @@
 #ifndef MATRIX_STACK_H
 #define MATRIX_STACK_H
 
-#include <vector>
 #include <vecmath.h>
 
+// A stack of at most MAX_DEPTH matrices (the identity at the bottom
+// counts as one), in a fixed array: pushing, popping and clearing never
+// touch the heap.  Pushing past MAX_DEPTH or popping the identity
+// prints an error and aborts.
 class MatrixStack
 {
 public:
+	static const int MAX_DEPTH = 64;
+
 	MatrixStack();
 	void clear();
-	Matrix4f top();
+	const Matrix4f& top() const;
 	void push( const Matrix4f& m );
 	void pop();
 
 private:
 
-	std::vector< Matrix4f > m_matrices;
+	Matrix4f m_matrices[ MAX_DEPTH ];
+	int m_size;
 };
 
 #endif // MATRIX_STACK_H
@@ -58,11 +58,11 @@ void Mesh::draw()
 	// Notice that since we have per-triangle normals
 	// rather than the analytical normals from
 	// assignment 1, the appearance is "faceted".
-	for (auto face : faces)
+	for (const auto& [a, b, c] : faces)
 	{
-		auto vert0 = currentVertices[face[0] - 1];
-		auto vert1 = currentVertices[face[1] - 1];
-		auto vert2 = currentVertices[face[2] - 1];
+		auto vert0 = currentVertices[a - 1];
+		auto vert1 = currentVertices[b - 1];
+		auto vert2 = currentVertices[c - 1];
 
 		auto normal = Vector3f::cross((vert1 - vert0), (vert2 - vert0)).normalized();
 
@@ -94,20 +94,41 @@ void Mesh::loadAttachments(const char* filename, int numJoints)
 
 	std::string str;
 	int attachmentNumber = 0;
-	while (true) {
+	bool complete = true;
+	while (complete) {
 		attachments.emplace_back(numJoints);
 		attachments[attachmentNumber][0] = 0.0; //root joint always have zero weight
 		for (int i = 0; i < numJoints - 1; ++i)
 		{
 			if (!std::getline(file, str, ' '))
-				return;
+			{
+				// the end of the file: drop the line just started
+				attachments.pop_back();
+				complete = false;
+				break;
+			}
 
 			attachments[attachmentNumber][i + 1] = std::stof(str);
 		}
 
+		if (!complete)
+			break;
+
 		std::getline(file, str);
 		assert(str.empty()); //skip new line character in the end of the line
 
 		++attachmentNumber;
 	}
+
+	influences.clear();
+	influenceOffsets.assign(1, 0);
+	for (const vector<float>& weights : attachments)
+	{
+		for (unsigned joint = 0; joint < weights.size(); ++joint)
+		{
+			if (weights[joint] != 0.0f)
+				influences.push_back({ joint, weights[joint] });
+		}
+		influenceOffsets.push_back(unsigned(influences.size()));
+	}
 }
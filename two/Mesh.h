@@ -34,6 +34,17 @@ struct Mesh
 	// one attachment weight per joint
 	std::vector< std::vector< float > > attachments;
 
+	// The nonzero attachments, vertex by vertex: those of vertex i are
+	// influences[ influenceOffsets[ i ] ] up to influences[ influenceOffsets[ i + 1 ] ].
+	// A vertex has a handful, against one weight per joint in attachments.
+	struct Influence
+	{
+		unsigned joint;
+		float weight;
+	};
+	std::vector< Influence > influences;
+	std::vector< unsigned > influenceOffsets;
+
 	// 2.1.1. load() should populate bindVertices, currentVertices, and faces
 	void load(const char *filename);
 
@@ -41,7 +52,7 @@ struct Mesh
 	void draw();
 
 	// 2.2. Implement this method to load the per-vertex attachment weights
-	// this method should update m_mesh.attachments
+	// this method should update m_mesh.attachments (and the influences)
 	void loadAttachments( const char* filename, int numJoints );
 };
 
@@ -124,14 +124,14 @@ void ModelerView::update()
 
 void ModelerView::updateJoints()
 {
-	for(unsigned int jointNo = 0; jointNo < 18; jointNo++)
+	// ( rx, ry, rz ) for every joint, converted in one batch
+	float angles[ 18 * 3 ];
+	for(unsigned int control = 0; control < 18 * 3; control++)
 	{
-		float rx = VAL( jointNo * 3 );
-		float ry = VAL( jointNo * 3 + 1 );
-		float rz = VAL( jointNo * 3 + 2 );
-
-		model.setJointTransform(jointNo, rx, ry, rz);
+		angles[ control ] = VAL( control );
 	}
+
+	model.setJointRotations(angles, 18);
 }
 
 // Call the draw function of the parent.  This sets up the
@@ -16,7 +16,7 @@ void SkeletalModel::load(const char* skeletonFile, const char* meshFile, const c
 	updateCurrentJointToWorldTransforms();
 }
 
-void SkeletalModel::draw(Matrix4f cameraMatrix, bool skeletonVisible)
+void SkeletalModel::draw(const Matrix4f& cameraMatrix, bool skeletonVisible)
 {
 	// draw() gets called whenever a redraw is required
 	// (after an update() occurs, when the camera moves, the window is resized, etc)
@@ -71,7 +71,7 @@ void SkeletalModel::loadSkeleton(const char* filename)
 
 		Joint* joint = new Joint;
 		m_joints.push_back(joint);
-		joint->transform = Matrix4f::translation(x, y, z);
+		joint->translation = Vector3f(x, y, z);
 		if (parent >= 0)
 		{
 			m_joints[parent]->children.push_back(joint);
@@ -100,7 +100,7 @@ void SkeletalModel::drawJoints()
 
 void SkeletalModel::drawJointsRecursive(const Joint* parent)
 {
-	m_matrixStack.push(parent->transform);
+	m_matrixStack.push(parent->transform());
 
 	glLoadMatrixf(m_matrixStack.top());
 	glutSolidSphere(0.025f, 12, 12);
@@ -120,11 +120,11 @@ void SkeletalModel::drawSkeleton()
 
 void SkeletalModel::drawSkeletonRecursive(const Joint* parent)
 {
-	m_matrixStack.push(parent->transform);
+	m_matrixStack.push(parent->transform());
 
 	for (auto child : parent->children)
 	{
-		auto childOffset = child->transform.getCol(3).xyz();
+		auto childOffset = child->translation;
 		auto distToChild = childOffset.abs();
 
 		if (distToChild > 0.f)
@@ -156,23 +156,21 @@ void SkeletalModel::drawSkeletonRecursive(const Joint* parent)
 
 void SkeletalModel::setJointTransform(int jointIndex, float rX, float rY, float rZ)
 {
-	// Set the rotation part of the joint's transformation matrix based on the passed in Euler angles.
-	auto rotateX = Matrix3f(
-		1, 0, 0,
-		0, cosf(rX), -sinf(rX),
-		0, sinf(rX), cosf(rX));
-
-	auto rotateY = Matrix3f(
-		cosf(rY), 0, sinf(rY),
-		0, 1, 0,
-		-sinf(rY), 0, cosf(rY));
-
-	auto rotateZ = Matrix3f(
-		cosf(rZ), -sinf(rZ), 0,
-		sinf(rZ), cosf(rZ), 0,
-		0, 0, 1);
-
-	m_joints[jointIndex]->transform.setSubmatrix3x3(0, 0, rotateZ * rotateY * rotateX);
+	// Set the rotation of the joint based on the passed in Euler angles.
+	float angles[3] = { rX, rY, rZ };
+	eulerToQuats(angles, &m_joints[jointIndex]->rotation, 1);
+}
+
+void SkeletalModel::setJointRotations(const float* anglesXYZ, size_t count)
+{
+	assert(count <= m_joints.size());
+
+	m_jointRotations.resize(count);
+	eulerToQuats(anglesXYZ, m_jointRotations.data(), count);
+	for (size_t jointNum = 0; jointNum < count; ++jointNum)
+	{
+		m_joints[jointNum]->rotation = m_jointRotations[jointNum];
+	}
 }
 
 
@@ -187,15 +185,20 @@ void SkeletalModel::computeBindWorldToJointTransforms()
 	// This method should update each joint's bindWorldToJointTransform.
 	// You will need to add a recursive helper function to traverse the joint hierarchy.
 
-	computeBindWorldToJointTransformsRecursive(m_rootJoint, Matrix4f::identity());
+	computeBindWorldToJointTransformsRecursive(m_rootJoint, Matrix4d::identity());
 }
 
-void SkeletalModel::computeBindWorldToJointTransformsRecursive(Joint* joint, const Matrix4f& parentBindWorldToJointTransform)
+void SkeletalModel::computeBindWorldToJointTransformsRecursive(Joint* joint, const Matrix4d& parentBindWorldToJointTransform)
 {
-	joint->bindWorldToJointTransform = joint->transform.inverse() * parentBindWorldToJointTransform; //TODO right order???
+	// The chain is composed in double so that deep skeletons far from
+	// the origin don't accumulate float round off; each joint keeps a
+	// float copy. Joint transforms are only ever a rotation and a
+	// translation.
+	Matrix4d bindWorldToJointTransform = Matrix4d(joint->transform()).rigidInverse() * parentBindWorldToJointTransform; //TODO right order???
+	joint->bindWorldToJointTransform = static_cast<Matrix4f>(bindWorldToJointTransform);
 	for (auto child : joint->children)
 	{
-		computeBindWorldToJointTransformsRecursive(child, joint->bindWorldToJointTransform);
+		computeBindWorldToJointTransformsRecursive(child, bindWorldToJointTransform);
 	}
 }
 
@@ -209,15 +212,18 @@ void SkeletalModel::updateCurrentJointToWorldTransforms()
 	//
 	// This method should update each joint's currentJointToWorldTransform.
 	// You will need to add a recursive helper function to traverse the joint hierarchy.
-	updateCurrentJointToWorldTransformsRecursive(m_rootJoint, Matrix4f::identity());
+	updateCurrentJointToWorldTransformsRecursive(m_rootJoint, Matrix4d::identity());
 }
 
-void SkeletalModel::updateCurrentJointToWorldTransformsRecursive(Joint* joint, const Matrix4f& parentCurrentJointToWorldTransform)
+void SkeletalModel::updateCurrentJointToWorldTransformsRecursive(Joint* joint, const Matrix4d& parentCurrentJointToWorldTransform)
 {
-	joint->currentJointToWorldTransform = parentCurrentJointToWorldTransform * joint->transform; //TODO right order???
+	// in double, like the bind pose chain; this is where the joint's
+	// rotation and translation become a matrix
+	Matrix4d currentJointToWorldTransform = parentCurrentJointToWorldTransform * Matrix4d(joint->transform()); //TODO right order???
+	joint->currentJointToWorldTransform = static_cast<Matrix4f>(currentJointToWorldTransform);
 	for (auto child : joint->children)
 	{
-		updateCurrentJointToWorldTransformsRecursive(child, joint->currentJointToWorldTransform);
+		updateCurrentJointToWorldTransformsRecursive(child, currentJointToWorldTransform);
 	}
 }
 
@@ -229,28 +235,36 @@ void SkeletalModel::updateMesh()
 	// You will need both the bind pose world --> joint transforms.
 	// and the current joint --> world transforms.
 
-	for (size_t vertNum = 0; vertNum < m_mesh.bindVertices.size(); ++vertNum)
+	size_t vertexCount = m_mesh.bindVertices.size();
+	assert(m_mesh.influenceOffsets.size() > vertexCount);
+
+#ifndef NDEBUG
+	for (size_t vertNum = 0; vertNum < vertexCount; ++vertNum)
 	{
-		Vector3f weightedAveragePoint(0, 0, 0);
 		assert(m_mesh.attachments[vertNum].size() == m_joints.size());
-		bool weightedAveragePointInit = false;
-		for (size_t jointNum = 0; jointNum < m_mesh.attachments[vertNum].size(); ++jointNum)
-		{
-			auto weight = m_mesh.attachments[vertNum][jointNum];
-			if (weight == 0.0f)
-				continue;
-
-			auto currWeightedPoint = weight
-				* (m_joints[jointNum]->currentJointToWorldTransform
-				* (m_joints[jointNum]->bindWorldToJointTransform
-				* Vector4f(m_mesh.bindVertices[vertNum], 1)));
-			weightedAveragePoint += currWeightedPoint.xyz();
-			weightedAveragePointInit = true;
-		}
+		assert(m_mesh.influenceOffsets[vertNum] < m_mesh.influenceOffsets[vertNum + 1]);
+	}
+#endif
 
-		assert(weightedAveragePointInit);
-		m_mesh.currentVertices[vertNum] = weightedAveragePoint;
+	// The palette: each joint's bind --> current transform, once.
+	m_skinningTransforms.resize(m_joints.size());
+	for (size_t jointNum = 0; jointNum < m_joints.size(); ++jointNum)
+	{
+		const Joint* joint = m_joints[jointNum];
+		m_skinningTransforms[jointNum] = joint->currentJointToWorldTransform * joint->bindWorldToJointTransform;
 	}
 
+	// Each vertex only goes through the few joints it is attached to.
+	const Mesh::Influence* influences = m_mesh.influences.data();
+	const unsigned* offsets = m_mesh.influenceOffsets.data();
+	for (size_t vertNum = 0; vertNum < vertexCount; ++vertNum)
+	{
+		Vector4f bindVertex(m_mesh.bindVertices[vertNum], 1);
+		Vector3f vertex(0, 0, 0);
+		for (unsigned k = offsets[vertNum]; k < offsets[vertNum + 1]; ++k)
+		{
+			vertex += influences[k].weight * (m_skinningTransforms[influences[k].joint] * bindVertex).xyz();
+		}
+		m_mesh.currentVertices[vertNum] = vertex;
+	}
 }
-
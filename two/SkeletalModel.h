@@ -34,7 +34,7 @@ class SkeletalModel
 public:
 	// Already-implemented utility functions that call the code you will write.
 	void load(const char *skeletonFile, const char *meshFile, const char *attachmentsFile);
-	void draw(Matrix4f cameraMatrix, bool drawSkeleton);
+	void draw(const Matrix4f& cameraMatrix, bool drawSkeleton);
 
 	// Part 1: Understanding Hierarchical Modeling
 
@@ -52,6 +52,10 @@ public:
 	// changes in the slider values
 	void setJointTransform( int jointIndex, float rX, float rY, float rZ );
 
+	// setJointTransform for the first count joints at once, from count
+	// ( rX, rY, rZ ) triples
+	void setJointRotations( const float* anglesXYZ, size_t count );
+
 	// Part 2: Skeletal Subspace Deformation
 
 	// 2.3. Implement SSD
@@ -79,15 +83,19 @@ private:
 	std::vector< Joint* > m_joints;
 
 	Mesh m_mesh;
+	// scratch for updateMesh: the bind --> current transform of each joint
+	std::vector< Matrix4f > m_skinningTransforms;
+	// scratch for setJointRotations
+	std::vector< Quat4f > m_jointRotations;
 
 	MatrixStack m_matrixStack;
 
 	void drawJointsRecursive(const Joint* parent);
 	void drawSkeletonRecursive(const Joint* parent);
 
-	static void computeBindWorldToJointTransformsRecursive(Joint* joint, const Matrix4f& parentBindWorldToJointTransform);
+	static void computeBindWorldToJointTransformsRecursive(Joint* joint, const Matrix4d& parentBindWorldToJointTransform);
 
-	static void updateCurrentJointToWorldTransformsRecursive(Joint* joint, const Matrix4f& parentCurrentJointToWorldTransform);
+	static void updateCurrentJointToWorldTransformsRecursive(Joint* joint, const Matrix4d& parentCurrentJointToWorldTransform);
 };
 
 #endif
@@ -234,7 +234,8 @@ Matrix4f Camera::viewMatrix() const
 		Vector3f::UP
 	);
     
-	return lookAt * mCurrentRot * Matrix4f::translation( -mCurrentCenter );
+	// all three are affine, so the projective row is left out
+	return ( Affine3f( lookAt ) * Affine3f( mCurrentRot ) * Affine3f::translation( -mCurrentCenter ) ).asMatrix4f();
 
 	/*
     gluLookAt(0,0,mCurrentDistance,
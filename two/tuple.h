@@ -1,69 +1,77 @@
 #ifndef TUPLE_H
 #define TUPLE_H
 
-#include <cstdarg>
-#include <cstdio>
-#include <cstdlib>
-#include <cstring>
+#include <cstddef>
 #include <iostream>
+#include <type_traits>
+#include <utility>
 
-// This is eugene going a little nuts with C++
+// A fixed-size array of SIZE values of TYPE.  It is a plain aggregate,
+// so it is trivially copyable when TYPE is, can be built in a constant
+// expression:
+//
+//   constexpr tuple< unsigned, 3 > face = { 0, 1, 2 };
+//
+// and an array of tuples is laid out as SIZE * count values, which can
+// be copied in bulk (to an element buffer, say).  It also decomposes in
+// a structured binding:
+//
+//   auto [ a, b, c ] = face;
+//
+// Like an array, a default-initialized tuple is uninitialized; write
+// tuple<...> t = {} for zeros.
 template <typename TYPE, unsigned SIZE>
-class tuple
+struct tuple
 {
-public:
-    
-    tuple() { }
-
-    tuple(TYPE first, ...)
-    {
-        data[ 0 ] = first;
-
-        va_list args;
-        va_start( args, first );
-        
-        for( unsigned i = 1; i < SIZE; ++i )
-        {
-            data[ i ] = va_arg( args, TYPE ); 
-        }
-
-        va_end( args );
+    constexpr TYPE& operator[](unsigned i) {
+        return data[i];
     }
 
-    tuple(const TYPE array[SIZE]) {
-        memcpy(data, array, SIZE * sizeof(TYPE));
-    }
-    
-    tuple(const tuple& other) {
-        memcpy(this->data, &other.data, SIZE * sizeof(TYPE));
+    constexpr const TYPE& operator[](unsigned i) const {
+        return data[i];
     }
 
-    tuple& operator=(const tuple& other) {
-        if (&other != this)
-            memcpy(this->data, &other.data, SIZE * sizeof(TYPE));
-        return *this;
-    }
-    
-    tuple& operator=(const TYPE array[SIZE]) {
-        memcpy(data, array, SIZE * sizeof(TYPE));
-        return *this;
+    constexpr TYPE* begin() { return data; }
+    constexpr TYPE* end() { return data + SIZE; }
+    constexpr const TYPE* begin() const { return data; }
+    constexpr const TYPE* end() const { return data + SIZE; }
+
+    // for structured bindings
+    template <std::size_t I>
+    constexpr TYPE& get() & {
+        static_assert(I < SIZE, "tuple index out of range");
+        return data[I];
     }
 
-    inline TYPE& operator[](unsigned i) {
-        return data[i];
+    template <std::size_t I>
+    constexpr const TYPE& get() const & {
+        static_assert(I < SIZE, "tuple index out of range");
+        return data[I];
     }
 
-    inline const TYPE& operator[](unsigned i) const {
-        return data[i];
+    template <std::size_t I>
+    constexpr TYPE&& get() && {
+        static_assert(I < SIZE, "tuple index out of range");
+        return std::move(data[I]);
     }
-    
-private:
+
     TYPE data[SIZE];
-    
 };
 
+static_assert(std::is_trivially_copyable< tuple< unsigned, 3 > >::value, "tuple must be trivially copyable");
+static_assert(sizeof(tuple< unsigned, 3 >) == 3 * sizeof(unsigned), "tuple must not be padded");
+
+namespace std
+{
+    template <typename TYPE, unsigned SIZE>
+    struct tuple_size< ::tuple<TYPE, SIZE> > : integral_constant<size_t, SIZE> { };
+
+    template <size_t I, typename TYPE, unsigned SIZE>
+    struct tuple_element< I, ::tuple<TYPE, SIZE> > { typedef TYPE type; };
+}
+
 template <typename TYPE, unsigned SIZE>
-std::ostream& operator<<(std::ostream &out, const tuple<TYPE,SIZE> x)
+std::ostream& operator<<(std::ostream &out, const tuple<TYPE,SIZE>& x)
 {
     out << '[';
     for (unsigned i=0; i<SIZE; i++)
@@ -0,0 +1,621 @@
+// Microbenchmarks for vecmath: the time of every operator and static
+// helper, the 4x4 kernels of Simd4f.h against the plain loops, the
+// affine inverses, the precision of the double and half types, and
+// the expression templates against the plain operators.
+//
+// usage: vecmath_bench [-o FILE] [-c BASELINE] [-t PERCENT]
+//
+//   -o  write the table of operations to FILE, one "name<TAB>ns" line
+//       each
+//   -c  compare the table against one written by -o, on the same
+//       machine and build, and report every operation that got slower
+//   -t  how much slower is a regression for -c, 25 percent by default
+//
+// The exit status is 1 if an operation regressed against the baseline,
+// the affine inverses disagree with the general inverse (benchAffine),
+// or the expression templates disagree with the plain operators
+// (benchExpressions).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <vecmath.h>
+#include <VectorExpression.h>
+
+using namespace std;
+
+namespace
+{
+	typedef chrono::steady_clock Clock;
+
+	double secondsSince(Clock::time_point start)
+	{
+		return chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Runs kernel(i) for i in [0, n) until at least seconds have passed
+	// and returns the average time per call in nanoseconds.
+	template <typename Kernel>
+	double timeKernel(unsigned n, const Kernel& kernel, double seconds = 0.2)
+	{
+		unsigned runs = 0;
+		Clock::time_point start = Clock::now();
+		do
+		{
+			for (unsigned i = 0; i < n; ++i)
+				kernel(i);
+			runs += n;
+		} while (secondsSince(start) < seconds);
+
+		return secondsSince(start) / runs * 1e9;
+	}
+
+	// The products as Matrix4f and Quat4f had them before Simd4f.h,
+	// through operator() and the accessors.
+	Matrix4f naiveMultiply(const Matrix4f& x, const Matrix4f& y)
+	{
+		Matrix4f product;
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				for (int k = 0; k < 4; ++k)
+					product(i, k) += x(i, j) * y(j, k);
+		return product;
+	}
+
+	Vector4f naiveTransform(const Matrix4f& m, const Vector4f& v)
+	{
+		Vector4f output(0, 0, 0, 0);
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				output[i] += m(i, j) * v[j];
+		return output;
+	}
+
+	Quat4f naiveQuatProduct(const Quat4f& q0, const Quat4f& q1)
+	{
+		return Quat4f(
+			q0.w() * q1.w() - q0.x() * q1.x() - q0.y() * q1.y() - q0.z() * q1.z(),
+			q0.w() * q1.x() + q0.x() * q1.w() + q0.y() * q1.z() - q0.z() * q1.y(),
+			q0.w() * q1.y() - q0.x() * q1.z() + q0.y() * q1.w() + q0.z() * q1.x(),
+			q0.w() * q1.z() + q0.x() * q1.y() - q0.y() * q1.x() + q0.z() * q1.w());
+	}
+
+	float randomFloat()
+	{
+		return rand() / float(RAND_MAX) - 0.5f;
+	}
+
+	// The 4x4 kernels of Simd4f.h on a few thousand random operands:
+	// the old loops, scalar4f and, where the build has it, simd4f.
+	// The inverse was already written out by cofactors, as scalar4f
+	// has it.
+	void benchKernels()
+	{
+		const unsigned n = 4096;
+
+		vector<Matrix4f> A(n), B(n), M(n);
+		vector<Vector4f> V(n), W(n);
+		vector<Quat4f> P(n), Q(n), R(n);
+		for (unsigned i = 0; i < n; ++i)
+		{
+			for (int j = 0; j < 16; ++j)
+			{
+				A[i][j] = randomFloat();
+				B[i][j] = randomFloat();
+			}
+			V[i] = Vector4f(randomFloat(), randomFloat(), randomFloat(), 1);
+			P[i] = Quat4f(randomFloat(), randomFloat(), randomFloat(), randomFloat());
+			Q[i] = Quat4f(randomFloat(), randomFloat(), randomFloat(), randomFloat());
+		}
+
+#if defined(VECMATH_SSE)
+		const char* simdName = "SSE";
+#elif defined(VECMATH_NEON)
+		const char* simdName = "NEON";
+#else
+		const char* simdName = "none";
+#endif
+
+		cout << endl << "4x4 kernels (" << n << " operands, SIMD: " << simdName << ")" << endl;
+		cout << setw(14) << "kernel" << setw(12) << "naive ns" << setw(12) << "scalar ns" << setw(12) << "simd ns" << endl;
+
+		double naive = timeKernel(n, [&](unsigned i) { M[i] = naiveMultiply(A[i], B[i]); });
+		double scalar = timeKernel(n, [&](unsigned i) { scalar4f::multiply(A[i], B[i], M[i]); });
+		double simd = 0;
+#if defined(VECMATH_SIMD)
+		simd = timeKernel(n, [&](unsigned i) { simd4f::multiply(A[i], B[i], M[i]); });
+#endif
+		cout << fixed << setprecision(2) << setw(14) << "mat * mat" << setw(12) << naive << setw(12) << scalar << setw(12) << simd << endl;
+
+		naive = timeKernel(n, [&](unsigned i) { W[i] = naiveTransform(A[i], V[i]); });
+		scalar = timeKernel(n, [&](unsigned i) { scalar4f::transform(A[i], V[i], W[i]); });
+#if defined(VECMATH_SIMD)
+		simd = timeKernel(n, [&](unsigned i) { simd4f::transform(A[i], V[i], W[i]); });
+#endif
+		cout << setw(14) << "mat * vec" << setw(12) << naive << setw(12) << scalar << setw(12) << simd << endl;
+
+		naive = timeKernel(n, [&](unsigned i) { R[i] = naiveQuatProduct(P[i], Q[i]); });
+		scalar = timeKernel(n, [&](unsigned i) { scalar4f::quatProduct(&P[i][0], &Q[i][0], &R[i][0]); });
+#if defined(VECMATH_SIMD)
+		simd = timeKernel(n, [&](unsigned i) { simd4f::quatProduct(&P[i][0], &Q[i][0], &R[i][0]); });
+#endif
+		cout << setw(14) << "quat * quat" << setw(12) << naive << setw(12) << scalar << setw(12) << simd << endl;
+
+		scalar = timeKernel(n, [&](unsigned i) { scalar4f::inverse(A[i], M[i]); });
+#if defined(VECMATH_SIMD)
+		simd = timeKernel(n, [&](unsigned i) { simd4f::inverse(A[i], M[i]); });
+#endif
+		cout << setw(14) << "inverse" << setw(12) << scalar << setw(12) << scalar << setw(12) << simd << defaultfloat << endl;
+	}
+
+	// Largest difference between the elements of a and b, relative to
+	// the largest element of b.
+	float relativeError(const Matrix4f& a, const Matrix4f& b)
+	{
+		float error = 0, scale = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			error = max(error, fabs(a[i] - b[i]));
+			scale = max(scale, fabs(b[i]));
+		}
+		return error / max(scale, 1.0f);
+	}
+
+	// Matrix4f::affineInverse and rigidInverse, and the Affine3f
+	// inverses and product, against the general inverse and product
+	// on random rigid and affine frames.  Returns false if any inverse
+	// is further than kInverseTolerance from the general one.
+	bool benchAffine()
+	{
+		const unsigned n = 4096;
+		const float kInverseTolerance = 1e-4f;
+
+		vector<Matrix4f> rigid(n), affine(n), M(n);
+		vector<Affine3f> rigidAffine(n), affineAffine(n), A(n);
+		for (unsigned i = 0; i < n; ++i)
+		{
+			Vector3f translation(4 * randomFloat(), 4 * randomFloat(), 4 * randomFloat());
+			Matrix4f rotation = Matrix4f::randomRotation(randomFloat() + 0.5f, randomFloat() + 0.5f, randomFloat() + 0.5f);
+
+			rigid[i] = Matrix4f::translation(translation) * rotation;
+			affine[i] = rigid[i] * Matrix4f::scaling(randomFloat() + 1.0f, randomFloat() + 1.0f, randomFloat() + 1.0f);
+			rigidAffine[i] = Affine3f(rigid[i]);
+			affineAffine[i] = Affine3f(affine[i]);
+		}
+
+		float affineError = 0, rigidError = 0;
+		for (unsigned i = 0; i < n; ++i)
+		{
+			affineError = max(affineError, relativeError(affine[i].affineInverse(), affine[i].inverse()));
+			affineError = max(affineError, relativeError(affineAffine[i].inverse().asMatrix4f(), affine[i].inverse()));
+			rigidError = max(rigidError, relativeError(rigid[i].rigidInverse(), rigid[i].inverse()));
+			rigidError = max(rigidError, relativeError(rigidAffine[i].rigidInverse().asMatrix4f(), rigid[i].inverse()));
+		}
+
+		cout << endl << "affine inverses (" << n << " frames)" << endl;
+		cout << setw(24) << "operation" << setw(12) << "ns" << endl;
+		cout << fixed << setprecision(2);
+
+		cout << setw(24) << "Matrix4f inverse" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { M[i] = affine[i].inverse(); }) << endl;
+		cout << setw(24) << "Matrix4f affineInverse" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { M[i] = affine[i].affineInverse(); }) << endl;
+		cout << setw(24) << "Matrix4f rigidInverse" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { M[i] = rigid[i].rigidInverse(); }) << endl;
+		cout << setw(24) << "Affine3f inverse" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { A[i] = affineAffine[i].inverse(); }) << endl;
+		cout << setw(24) << "Affine3f rigidInverse" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { A[i] = rigidAffine[i].rigidInverse(); }) << endl;
+		cout << setw(24) << "Matrix4f product" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { M[i] = affine[i] * rigid[(i + 1) % n]; }) << endl;
+		cout << setw(24) << "Affine3f product" << setw(12)
+			<< timeKernel(n, [&](unsigned i) { A[i] = affineAffine[i] * rigidAffine[(i + 1) % n]; }) << endl;
+
+		bool ok = affineError < kInverseTolerance && rigidError < kInverseTolerance;
+		cout << defaultfloat << "max relative error against inverse: affine " << affineError
+			<< ", rigid " << rigidError << (ok ? " (ok)" : " (FAILED)") << endl;
+		return ok;
+	}
+
+	// Precision of the vecmath types: a chain of rigid joints far from
+	// the origin composed in float and in double, as the skeleton of
+	// assignment two composes its bind pose, and the round trip of a
+	// vertex array through half precision storage.
+	void benchPrecision()
+	{
+		const unsigned joints = 64;
+		const unsigned n = 1 << 16;
+
+		Matrix4f chain = Matrix4f::translation(1e4f, -2e4f, 3e4f);
+		Matrix4d chainDouble(chain);
+		for (unsigned i = 0; i < joints; ++i)
+		{
+			Matrix4f joint = Matrix4f::translation(randomFloat(), randomFloat(), randomFloat())
+				* Matrix4f::randomRotation(randomFloat() + 0.5f, randomFloat() + 0.5f, randomFloat() + 0.5f);
+			chain = chain * joint;
+			chainDouble = chainDouble * Matrix4d(joint);
+		}
+
+		// how far the float chain puts the last joint from the double one
+		Matrix4f narrowed = static_cast<Matrix4f>(chainDouble);
+		float chainError = (chain.getCol(3).xyz() - narrowed.getCol(3).xyz()).abs();
+
+		vector<Vector3f> V(n), W(n);
+		vector<Vector3h> H(n);
+		for (unsigned i = 0; i < n; ++i)
+			V[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+
+		Clock::time_point start = Clock::now();
+		narrow(V.data(), H.data(), n);
+		double narrowNs = secondsSince(start) * 1e9 / n;
+
+		start = Clock::now();
+		widen(H.data(), W.data(), n);
+		double widenNs = secondsSince(start) * 1e9 / n;
+
+		float halfError = 0;
+		for (unsigned i = 0; i < n; ++i)
+			halfError = max(halfError, (W[i] - V[i]).abs());
+
+		cout << endl << "precision (" << joints << " joint chain, " << n << " vertices)" << endl;
+		cout << "last joint, float chain against double chain: " << chainError << " units" << endl;
+		cout << fixed << setprecision(2) << "half storage: narrow " << narrowNs << " ns, widen " << widenNs
+			<< " ns per vertex, " << sizeof(Vector3h) << " bytes" << defaultfloat
+			<< ", max error " << halfError << endl;
+	}
+
+	// The plain operators against the expression templates of
+	// VectorExpression.h on the kernels they were written for: a cubic
+	// piece evaluated as in CurvePiece::eval of assignment one, the
+	// weighted sum of the skinning in SkeletalModel::updateMesh of
+	// assignment two, and a four-term Vector4f blend.  Both sides must
+	// agree bit for bit.
+	bool benchExpressions()
+	{
+		using vecexpr::lazy;
+
+		const unsigned n = 4096;
+
+		vector<Vector3f> P(n + 3), V(n), D(n), skinned(n), current(n);
+		vector<Vector4f> A(n + 3), B(n);
+		vector<float> t(n), weight(n);
+		for (unsigned i = 0; i < n + 3; ++i)
+		{
+			P[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+			A[i] = Vector4f(randomFloat(), randomFloat(), randomFloat(), randomFloat());
+		}
+		for (unsigned i = 0; i < n; ++i)
+		{
+			t[i] = randomFloat() + 0.5f;
+			weight[i] = randomFloat() + 0.5f;
+			skinned[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+		}
+
+		// the Bernstein weights and their derivatives at t
+		auto bezier = [](float t, float* w, float* d)
+		{
+			float s = 1 - t;
+			w[0] = s * s * s; w[1] = 3 * t * s * s; w[2] = 3 * t * t * s; w[3] = t * t * t;
+			d[0] = -3 * s * s; d[1] = 3 * s * (s - 2 * t); d[2] = 3 * t * (2 * s - t); d[3] = 3 * t * t;
+		};
+
+		auto curvePlain = [&](unsigned i)
+		{
+			float w[4], d[4];
+			bezier(t[i], w, d);
+			const Vector3f* p = &P[i];
+			V[i] = p[0] * w[0] + p[1] * w[1] + p[2] * w[2] + p[3] * w[3];
+			D[i] = p[0] * d[0] + p[1] * d[1] + p[2] * d[2] + p[3] * d[3];
+		};
+		auto curveLazy = [&](unsigned i)
+		{
+			float w[4], d[4];
+			bezier(t[i], w, d);
+			const Vector3f* p = &P[i];
+			V[i] = lazy(p[0]) * w[0] + lazy(p[1]) * w[1] + lazy(p[2]) * w[2] + lazy(p[3]) * w[3];
+			D[i] = lazy(p[0]) * d[0] + lazy(p[1]) * d[1] + lazy(p[2]) * d[2] + lazy(p[3]) * d[3];
+		};
+		auto skinPlain = [&](unsigned i) { current[i] += weight[i] * skinned[i]; };
+		auto skinLazy = [&](unsigned i) { current[i] += weight[i] * lazy(skinned[i]); };
+		auto blendPlain = [&](unsigned i) { B[i] = A[i] * t[i] + A[i + 1] * weight[i] - A[i + 2] + A[i + 3] * 0.5f; };
+		auto blendLazy = [&](unsigned i) { B[i] = lazy(A[i]) * t[i] + lazy(A[i + 1]) * weight[i] - A[i + 2] + lazy(A[i + 3]) * 0.5f; };
+
+		// both ways must give the same bits
+		bool same = true;
+		vector<Vector3f> V0(n), D0(n);
+		vector<Vector4f> B0(n);
+		for (unsigned i = 0; i < n; ++i)
+		{
+			curvePlain(i);
+			blendPlain(i);
+		}
+		V0 = V; D0 = D; B0 = B;
+		for (unsigned i = 0; i < n; ++i)
+		{
+			curveLazy(i);
+			blendLazy(i);
+			Vector3f a = skinned[i], b = skinned[i];
+			a += weight[i] * skinned[(i + 1) % n];
+			b += weight[i] * lazy(skinned[(i + 1) % n]);
+			same = same && V[i] == V0[i] && D[i] == D0[i] && B[i] == B0[i] && a == b;
+		}
+
+		cout << endl << "expression templates (" << n << " operands)" << endl;
+		cout << setw(14) << "kernel" << setw(12) << "plain ns" << setw(12) << "lazy ns" << endl;
+		cout << fixed << setprecision(2);
+		cout << setw(14) << "cubic piece" << setw(12) << timeKernel(n, curvePlain) << setw(12) << timeKernel(n, curveLazy) << endl;
+		cout << setw(14) << "skinning" << setw(12) << timeKernel(n, skinPlain) << setw(12) << timeKernel(n, skinLazy) << endl;
+		cout << setw(14) << "Vector4f blend" << setw(12) << timeKernel(n, blendPlain) << setw(12) << timeKernel(n, blendLazy) << endl;
+		cout << defaultfloat << "results " << (same ? "identical" : "DIFFER") << endl;
+
+		return same;
+	}
+
+	// One row of the table of operations.
+	struct Timing
+	{
+		string name;
+		double ns;
+	};
+
+	// Every operator and static helper of the float types, Affine3f,
+	// the double types and Half, each on n random operands.  The
+	// results go to arrays so that no call can be optimized away.
+	vector<Timing> benchOperations()
+	{
+		const unsigned n = 1024;
+		const double seconds = 0.02;
+		const int runs = 5;
+
+		vector<Vector2f> a2(n), b2(n), r2(n);
+		vector<Vector3f> a3(n), b3(n), c3(n), d3(n), r3(n);
+		vector<Vector4f> a4(n), b4(n), r4(n);
+		vector<Matrix2f> m2(n), n2(n), rm2(n);
+		vector<Matrix3f> m3(n), n3(n), rm3(n);
+		vector<Matrix4f> m4(n), n4(n), rigid(n), rm4(n);
+		vector<Quat4f> p(n), q(n), rq(n);
+		vector<Affine3f> affine(n), ra(n);
+		vector<Matrix4d> m4d(n), rm4d(n);
+		vector<Half> h(n);
+		vector<float> f(n), rf(n);
+
+		for (unsigned i = 0; i < n; ++i)
+		{
+			a2[i] = Vector2f(randomFloat(), randomFloat());
+			b2[i] = Vector2f(randomFloat(), randomFloat());
+			a3[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+			b3[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+			c3[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+			d3[i] = Vector3f(randomFloat(), randomFloat(), randomFloat());
+			a4[i] = Vector4f(randomFloat(), randomFloat(), randomFloat(), 1);
+			b4[i] = Vector4f(randomFloat(), randomFloat(), randomFloat(), 1);
+			for (int j = 0; j < 4; ++j)
+			{
+				m2[i](j / 2, j % 2) = randomFloat();
+				n2[i](j / 2, j % 2) = randomFloat();
+			}
+			for (int j = 0; j < 9; ++j)
+			{
+				m3[i](j / 3, j % 3) = randomFloat();
+				n3[i](j / 3, j % 3) = randomFloat();
+			}
+			for (int j = 0; j < 16; ++j)
+			{
+				m4[i][j] = randomFloat();
+				n4[i][j] = randomFloat();
+			}
+			p[i] = Quat4f(randomFloat(), randomFloat(), randomFloat(), randomFloat()).normalized();
+			q[i] = Quat4f(randomFloat(), randomFloat(), randomFloat(), randomFloat()).normalized();
+			rigid[i] = Matrix4f::translation(a3[i]) * Matrix4f::rotation(p[i]);
+			affine[i] = Affine3f(rigid[i] * Matrix4f::uniformScaling(randomFloat() + 1.0f));
+			m4d[i] = Matrix4d(m4[i]);
+			f[i] = 100 * randomFloat();
+			h[i] = Half(f[i]);
+		}
+
+		vector<Timing> timings;
+		cout << endl << "operations (" << n << " operands)" << endl;
+		cout << setw(36) << "operation" << setw(12) << "ns" << endl;
+		cout << fixed << setprecision(2);
+
+		// the best of a few short runs, which is steadier than one long
+		// one on a busy machine
+		auto time = [&](const char* name, auto kernel)
+		{
+			Timing timing = { name, timeKernel(n, kernel, seconds) };
+			for (int run = 1; run < runs; ++run)
+				timing.ns = min(timing.ns, timeKernel(n, kernel, seconds));
+			timings.push_back(timing);
+			cout << setw(36) << name << setw(12) << timing.ns << endl;
+		};
+
+		time("Vector2f +", [&](unsigned i) { r2[i] = a2[i] + b2[i]; });
+		time("Vector2f * float", [&](unsigned i) { r2[i] = a2[i] * f[i]; });
+		time("Vector2f::dot", [&](unsigned i) { rf[i] = Vector2f::dot(a2[i], b2[i]); });
+		time("Vector2f::cross", [&](unsigned i) { r3[i] = Vector2f::cross(a2[i], b2[i]); });
+		time("Vector2f::abs", [&](unsigned i) { rf[i] = a2[i].abs(); });
+		time("Vector2f::normalized", [&](unsigned i) { r2[i] = a2[i].normalized(); });
+		time("Vector2f::lerp", [&](unsigned i) { r2[i] = Vector2f::lerp(a2[i], b2[i], f[i]); });
+
+		time("Vector3f +", [&](unsigned i) { r3[i] = a3[i] + b3[i]; });
+		time("Vector3f -", [&](unsigned i) { r3[i] = a3[i] - b3[i]; });
+		time("Vector3f * Vector3f", [&](unsigned i) { r3[i] = a3[i] * b3[i]; });
+		time("Vector3f * float", [&](unsigned i) { r3[i] = a3[i] * f[i]; });
+		time("Vector3f / float", [&](unsigned i) { r3[i] = a3[i] / f[i]; });
+		time("Vector3f +=", [&](unsigned i) { r3[i] += a3[i]; });
+		time("Vector3f::dot", [&](unsigned i) { rf[i] = Vector3f::dot(a3[i], b3[i]); });
+		time("Vector3f::cross", [&](unsigned i) { r3[i] = Vector3f::cross(a3[i], b3[i]); });
+		time("Vector3f::abs", [&](unsigned i) { rf[i] = a3[i].abs(); });
+		time("Vector3f::normalized", [&](unsigned i) { r3[i] = a3[i].normalized(); });
+		time("Vector3f::lerp", [&](unsigned i) { r3[i] = Vector3f::lerp(a3[i], b3[i], f[i]); });
+		time("Vector3f::cubicInterpolate", [&](unsigned i) { r3[i] = Vector3f::cubicInterpolate(a3[i], b3[i], c3[i], d3[i], f[i]); });
+
+		time("Vector4f +", [&](unsigned i) { r4[i] = a4[i] + b4[i]; });
+		time("Vector4f * float", [&](unsigned i) { r4[i] = a4[i] * f[i]; });
+		time("Vector4f::dot", [&](unsigned i) { rf[i] = Vector4f::dot(a4[i], b4[i]); });
+		time("Vector4f::abs", [&](unsigned i) { rf[i] = a4[i].abs(); });
+		time("Vector4f::normalized", [&](unsigned i) { r4[i] = a4[i].normalized(); });
+		time("Vector4f::homogenized", [&](unsigned i) { r4[i] = a4[i].homogenized(); });
+		time("Vector4f::lerp", [&](unsigned i) { r4[i] = Vector4f::lerp(a4[i], b4[i], f[i]); });
+
+		time("Matrix2f * Matrix2f", [&](unsigned i) { rm2[i] = m2[i] * n2[i]; });
+		time("Matrix2f * Vector2f", [&](unsigned i) { r2[i] = m2[i] * a2[i]; });
+		time("Matrix2f::determinant", [&](unsigned i) { rf[i] = m2[i].determinant(); });
+		time("Matrix2f::inverse", [&](unsigned i) { rm2[i] = m2[i].inverse(); });
+		time("Matrix2f::transposed", [&](unsigned i) { rm2[i] = m2[i].transposed(); });
+		time("Matrix2f::rotation", [&](unsigned i) { rm2[i] = Matrix2f::rotation(f[i]); });
+
+		time("Matrix3f * Matrix3f", [&](unsigned i) { rm3[i] = m3[i] * n3[i]; });
+		time("Matrix3f * Vector3f", [&](unsigned i) { r3[i] = m3[i] * a3[i]; });
+		time("Matrix3f::determinant", [&](unsigned i) { rf[i] = m3[i].determinant(); });
+		time("Matrix3f::inverse", [&](unsigned i) { rm3[i] = m3[i].inverse(); });
+		time("Matrix3f::transposed", [&](unsigned i) { rm3[i] = m3[i].transposed(); });
+		time("Matrix3f::rotateX", [&](unsigned i) { rm3[i] = Matrix3f::rotateX(f[i]); });
+		time("Matrix3f::rotation(axis)", [&](unsigned i) { rm3[i] = Matrix3f::rotation(a3[i], f[i]); });
+		time("Matrix3f::rotation(quat)", [&](unsigned i) { rm3[i] = Matrix3f::rotation(p[i]); });
+
+		time("Matrix4f * Matrix4f", [&](unsigned i) { rm4[i] = m4[i] * n4[i]; });
+		time("Matrix4f * Vector4f", [&](unsigned i) { r4[i] = m4[i] * a4[i]; });
+		time("Matrix4f::determinant", [&](unsigned i) { rf[i] = m4[i].determinant(); });
+		time("Matrix4f::inverse", [&](unsigned i) { rm4[i] = m4[i].inverse(); });
+		time("Matrix4f::affineInverse", [&](unsigned i) { rm4[i] = rigid[i].affineInverse(); });
+		time("Matrix4f::rigidInverse", [&](unsigned i) { rm4[i] = rigid[i].rigidInverse(); });
+		time("Matrix4f::transposed", [&](unsigned i) { rm4[i] = m4[i].transposed(); });
+		time("Matrix4f::translation", [&](unsigned i) { rm4[i] = Matrix4f::translation(a3[i]); });
+		time("Matrix4f::scaling", [&](unsigned i) { rm4[i] = Matrix4f::scaling(a3[i][0], a3[i][1], a3[i][2]); });
+		time("Matrix4f::rotation(axis)", [&](unsigned i) { rm4[i] = Matrix4f::rotation(a3[i], f[i]); });
+		time("Matrix4f::rotation(quat)", [&](unsigned i) { rm4[i] = Matrix4f::rotation(p[i]); });
+		time("Matrix4f::lookAt", [&](unsigned i) { rm4[i] = Matrix4f::lookAt(a3[i], b3[i], c3[i]); });
+		time("Matrix4f::perspectiveProjection", [&](unsigned i) { rm4[i] = Matrix4f::perspectiveProjection(1.0f, f[i], 0.1f, 100.0f, false); });
+		time("transformPoints x64", [&](unsigned i) { transformPoints(m4[i], &a3[0], &r3[0], 64); });
+		time("transformNormals x64", [&](unsigned i) { transformNormals(m4[i], &a3[0], &r3[0], 64); });
+
+		time("Quat4f +", [&](unsigned i) { rq[i] = p[i] + q[i]; });
+		time("Quat4f * Quat4f", [&](unsigned i) { rq[i] = p[i] * q[i]; });
+		time("Quat4f * float", [&](unsigned i) { rq[i] = p[i] * f[i]; });
+		time("Quat4f::dot", [&](unsigned i) { rf[i] = Quat4f::dot(p[i], q[i]); });
+		time("Quat4f::normalized", [&](unsigned i) { rq[i] = p[i].normalized(); });
+		time("Quat4f::conjugated", [&](unsigned i) { rq[i] = p[i].conjugated(); });
+		time("Quat4f::inverse", [&](unsigned i) { rq[i] = p[i].inverse(); });
+		time("Quat4f::log", [&](unsigned i) { rq[i] = p[i].log(); });
+		time("Quat4f::exp", [&](unsigned i) { rq[i] = p[i].exp(); });
+		time("Quat4f::getAxisAngle", [&](unsigned i) { r3[i] = p[i].getAxisAngle(&rf[i]); });
+		time("Quat4f::setAxisAngle", [&](unsigned i) { rq[i].setAxisAngle(f[i], a3[i]); });
+		time("Quat4f::lerp", [&](unsigned i) { rq[i] = Quat4f::lerp(p[i], q[i], f[i]); });
+		time("Quat4f::slerp", [&](unsigned i) { rq[i] = Quat4f::slerp(p[i], q[i], f[i]); });
+		time("Quat4f::squad", [&](unsigned i) { rq[i] = Quat4f::squad(p[i], q[i], p[(i + 1) % n], q[(i + 1) % n], f[i]); });
+		time("Quat4f::fromRotationMatrix", [&](unsigned i) { rq[i] = Quat4f::fromRotationMatrix(m3[i]); });
+
+		time("Affine3f * Affine3f", [&](unsigned i) { ra[i] = affine[i] * affine[(i + 1) % n]; });
+		time("Affine3f::transformPoint", [&](unsigned i) { r3[i] = affine[i].transformPoint(a3[i]); });
+		time("Affine3f::inverse", [&](unsigned i) { ra[i] = affine[i].inverse(); });
+		time("Affine3f::rigidInverse", [&](unsigned i) { ra[i] = affine[i].rigidInverse(); });
+
+		time("Matrix4d * Matrix4d", [&](unsigned i) { rm4d[i] = m4d[i] * m4d[(i + 1) % n]; });
+		time("Matrix4d::inverse", [&](unsigned i) { rm4d[i] = m4d[i].inverse(); });
+		time("Half(float)", [&](unsigned i) { h[i] = Half(f[i]); });
+		time("float(Half)", [&](unsigned i) { rf[i] = float(h[i]); });
+
+		cout << defaultfloat;
+		return timings;
+	}
+
+	void writeTimings(const string& filename, const vector<Timing>& timings)
+	{
+		ofstream out(filename.c_str());
+		for (size_t i = 0; i < timings.size(); ++i)
+			out << timings[i].name << '\t' << timings[i].ns << endl;
+	}
+
+	// Reports every operation more than tolerance (a fraction) slower
+	// than in the baseline file, and returns false if there's any.
+	bool compareTimings(const string& filename, const vector<Timing>& timings, double tolerance)
+	{
+		ifstream in(filename.c_str());
+		if (!in)
+		{
+			cerr << "could not open baseline " << filename << endl;
+			return false;
+		}
+
+		map<string, double> baseline;
+		string line;
+		while (getline(in, line))
+		{
+			string::size_type tab = line.rfind('\t');
+			if (tab != string::npos)
+				baseline[line.substr(0, tab)] = atof(line.c_str() + tab + 1);
+		}
+
+		cout << endl << "against " << filename << " (tolerance " << tolerance * 100 << "%)" << endl;
+
+		unsigned regressions = 0;
+		for (size_t i = 0; i < timings.size(); ++i)
+		{
+			map<string, double>::const_iterator b = baseline.find(timings[i].name);
+			if (b == baseline.end() || b->second <= 0)
+				continue;
+
+			double ratio = timings[i].ns / b->second;
+			if (ratio > 1 + tolerance)
+			{
+				cout << setw(36) << timings[i].name << fixed << setprecision(2)
+					<< setw(12) << b->second << " -> " << timings[i].ns << " ns" << defaultfloat << endl;
+				++regressions;
+			}
+		}
+
+		cout << regressions << " of " << timings.size() << " operations regressed" << endl;
+		return regressions == 0;
+	}
+
+	void usage(const char* program)
+	{
+		cerr << "usage: " << program << " [-o FILE] [-c BASELINE] [-t PERCENT]" << endl;
+		exit(1);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	string outFile, baselineFile;
+	double tolerance = 0.25;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg(argv[i]);
+
+		if (i + 1 >= argc)
+			usage(argv[0]);
+
+		if (arg == "-o")
+			outFile = argv[++i];
+		else if (arg == "-c")
+			baselineFile = argv[++i];
+		else if (arg == "-t")
+			tolerance = atof(argv[++i]) / 100;
+		else
+			usage(argv[0]);
+	}
+
+	vector<Timing> timings = benchOperations();
+	benchKernels();
+	bool affineOk = benchAffine();
+	benchPrecision();
+	bool expressionsOk = benchExpressions();
+
+	if (!outFile.empty())
+		writeTimings(outFile, timings);
+
+	bool timingsOk = baselineFile.empty() || compareTimings(baselineFile, timings, tolerance);
+
+	return affineOk && expressionsOk && timingsOk ? 0 : 1;
+}
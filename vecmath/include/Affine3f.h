@@ -0,0 +1,268 @@
+#ifndef AFFINE3F_H
+#define AFFINE3F_H
+
+#include <cstdio>
+
+class Matrix3f;
+class Matrix4f;
+class Vector3f;
+
+// Affine transform p --> A p + t, stored as the top three rows of the
+// equivalent Matrix4f, in column major order (OpenGL style).  The
+// bottom row is always ( 0 0 0 1 ) and is neither stored nor
+// multiplied, so composing two of them takes 36 products instead of 64.
+class Affine3f
+{
+public:
+
+	// identity
+	constexpr Affine3f();
+
+	constexpr Affine3f( float m00, float m01, float m02, float m03,
+		float m10, float m11, float m12, float m13,
+		float m20, float m21, float m22, float m23 );
+
+	Affine3f( const Matrix3f& linear, const Vector3f& translation );
+
+	// the top three rows of m; its bottom row is assumed to be ( 0 0 0 1 )
+	explicit Affine3f( const Matrix4f& m );
+
+	Affine3f( const Affine3f& ra ) = default; // copy constructor
+	Affine3f& operator = ( const Affine3f& ra ) = default; // assignment operator
+	// no destructor necessary
+
+	// i in [0, 3), j in [0, 4)
+	constexpr const float& operator () ( int i, int j ) const;
+	constexpr float& operator () ( int i, int j );
+
+	Matrix3f linear() const;
+	Vector3f translation() const;
+	Matrix4f asMatrix4f() const;
+
+	// A p + t
+	Vector3f transformPoint( const Vector3f& p ) const;
+	// A v
+	Vector3f transformVector( const Vector3f& v ) const;
+
+	// The general affine inverse ( A^-1, -A^-1 t ).  Returns 0 and
+	// sets *pbIsSingular if |det( A )| < epsilon, like Matrix4f::inverse.
+	Affine3f inverse( bool* pbIsSingular = NULL, float epsilon = 0.f ) const;
+
+	// ( A^T, -A^T t ), the inverse when A is a rotation
+	Affine3f rigidInverse() const;
+
+	// ---- Utility ----
+	void print();
+
+	static Affine3f identity();
+	static Affine3f translation( const Vector3f& rTranslation );
+
+private:
+
+	float m_elements[ 12 ];
+
+};
+
+// Affine-Affine composition: ( x * y )( p ) = x( y( p ) )
+Affine3f operator * ( const Affine3f& x, const Affine3f& y );
+
+#include <cmath>
+
+#include "Matrix3f.h"
+#include "Matrix4f.h"
+#include "Vector3f.h"
+
+constexpr Affine3f::Affine3f()
+	: m_elements{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 }
+{
+}
+
+constexpr Affine3f::Affine3f( float m00, float m01, float m02, float m03,
+				   float m10, float m11, float m12, float m13,
+				   float m20, float m21, float m22, float m23 )
+	: m_elements{ m00, m10, m20, m01, m11, m21, m02, m12, m22, m03, m13, m23 }
+{
+}
+
+inline Affine3f::Affine3f( const Matrix3f& linear, const Vector3f& translation )
+	: m_elements{ linear( 0, 0 ), linear( 1, 0 ), linear( 2, 0 ),
+		linear( 0, 1 ), linear( 1, 1 ), linear( 2, 1 ),
+		linear( 0, 2 ), linear( 1, 2 ), linear( 2, 2 ),
+		translation[ 0 ], translation[ 1 ], translation[ 2 ] }
+{
+}
+
+inline Affine3f::Affine3f( const Matrix4f& m )
+	: m_elements{ m( 0, 0 ), m( 1, 0 ), m( 2, 0 ),
+		m( 0, 1 ), m( 1, 1 ), m( 2, 1 ),
+		m( 0, 2 ), m( 1, 2 ), m( 2, 2 ),
+		m( 0, 3 ), m( 1, 3 ), m( 2, 3 ) }
+{
+}
+
+constexpr const float& Affine3f::operator () ( int i, int j ) const
+{
+	return m_elements[ j * 3 + i ];
+}
+
+constexpr float& Affine3f::operator () ( int i, int j )
+{
+	return m_elements[ j * 3 + i ];
+}
+
+inline Matrix3f Affine3f::linear() const
+{
+	return Matrix3f
+	(
+		m_elements[ 0 ], m_elements[ 3 ], m_elements[ 6 ],
+		m_elements[ 1 ], m_elements[ 4 ], m_elements[ 7 ],
+		m_elements[ 2 ], m_elements[ 5 ], m_elements[ 8 ]
+	);
+}
+
+inline Vector3f Affine3f::translation() const
+{
+	return Vector3f( m_elements[ 9 ], m_elements[ 10 ], m_elements[ 11 ] );
+}
+
+inline Matrix4f Affine3f::asMatrix4f() const
+{
+	return Matrix4f
+	(
+		m_elements[ 0 ], m_elements[ 3 ], m_elements[ 6 ], m_elements[ 9 ],
+		m_elements[ 1 ], m_elements[ 4 ], m_elements[ 7 ], m_elements[ 10 ],
+		m_elements[ 2 ], m_elements[ 5 ], m_elements[ 8 ], m_elements[ 11 ],
+		0, 0, 0, 1
+	);
+}
+
+inline Vector3f Affine3f::transformPoint( const Vector3f& p ) const
+{
+	return Vector3f
+	(
+		m_elements[ 0 ] * p[ 0 ] + m_elements[ 3 ] * p[ 1 ] + m_elements[ 6 ] * p[ 2 ] + m_elements[ 9 ],
+		m_elements[ 1 ] * p[ 0 ] + m_elements[ 4 ] * p[ 1 ] + m_elements[ 7 ] * p[ 2 ] + m_elements[ 10 ],
+		m_elements[ 2 ] * p[ 0 ] + m_elements[ 5 ] * p[ 1 ] + m_elements[ 8 ] * p[ 2 ] + m_elements[ 11 ]
+	);
+}
+
+inline Vector3f Affine3f::transformVector( const Vector3f& v ) const
+{
+	return Vector3f
+	(
+		m_elements[ 0 ] * v[ 0 ] + m_elements[ 3 ] * v[ 1 ] + m_elements[ 6 ] * v[ 2 ],
+		m_elements[ 1 ] * v[ 0 ] + m_elements[ 4 ] * v[ 1 ] + m_elements[ 7 ] * v[ 2 ],
+		m_elements[ 2 ] * v[ 0 ] + m_elements[ 5 ] * v[ 1 ] + m_elements[ 8 ] * v[ 2 ]
+	);
+}
+
+inline Affine3f Affine3f::inverse( bool* pbIsSingular, float epsilon ) const
+{
+	const float* m = m_elements;
+
+	// the cofactors of A, which are the transposed rows of its adjugate
+	float cofactor00 = m[ 4 ] * m[ 8 ] - m[ 7 ] * m[ 5 ];
+	float cofactor01 = m[ 7 ] * m[ 2 ] - m[ 1 ] * m[ 8 ];
+	float cofactor02 = m[ 1 ] * m[ 5 ] - m[ 4 ] * m[ 2 ];
+	float cofactor10 = m[ 6 ] * m[ 5 ] - m[ 3 ] * m[ 8 ];
+	float cofactor11 = m[ 0 ] * m[ 8 ] - m[ 6 ] * m[ 2 ];
+	float cofactor12 = m[ 3 ] * m[ 2 ] - m[ 0 ] * m[ 5 ];
+	float cofactor20 = m[ 3 ] * m[ 7 ] - m[ 6 ] * m[ 4 ];
+	float cofactor21 = m[ 6 ] * m[ 1 ] - m[ 0 ] * m[ 7 ];
+	float cofactor22 = m[ 0 ] * m[ 4 ] - m[ 3 ] * m[ 1 ];
+
+	float determinant = m[ 0 ] * cofactor00 + m[ 3 ] * cofactor01 + m[ 6 ] * cofactor02;
+
+	bool isSingular = ( fabs( determinant ) < epsilon );
+	if( pbIsSingular != NULL )
+	{
+		*pbIsSingular = isSingular;
+	}
+
+	if( isSingular )
+	{
+		return Affine3f( 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 );
+	}
+
+	float r = 1.0f / determinant;
+	float i00 = cofactor00 * r, i01 = cofactor10 * r, i02 = cofactor20 * r;
+	float i10 = cofactor01 * r, i11 = cofactor11 * r, i12 = cofactor21 * r;
+	float i20 = cofactor02 * r, i21 = cofactor12 * r, i22 = cofactor22 * r;
+
+	return Affine3f
+	(
+		i00, i01, i02, -( i00 * m[ 9 ] + i01 * m[ 10 ] + i02 * m[ 11 ] ),
+		i10, i11, i12, -( i10 * m[ 9 ] + i11 * m[ 10 ] + i12 * m[ 11 ] ),
+		i20, i21, i22, -( i20 * m[ 9 ] + i21 * m[ 10 ] + i22 * m[ 11 ] )
+	);
+}
+
+inline Affine3f Affine3f::rigidInverse() const
+{
+	const float* m = m_elements;
+
+	// the rows of A are the columns of A^T
+	return Affine3f
+	(
+		m[ 0 ], m[ 1 ], m[ 2 ], -( m[ 0 ] * m[ 9 ] + m[ 1 ] * m[ 10 ] + m[ 2 ] * m[ 11 ] ),
+		m[ 3 ], m[ 4 ], m[ 5 ], -( m[ 3 ] * m[ 9 ] + m[ 4 ] * m[ 10 ] + m[ 5 ] * m[ 11 ] ),
+		m[ 6 ], m[ 7 ], m[ 8 ], -( m[ 6 ] * m[ 9 ] + m[ 7 ] * m[ 10 ] + m[ 8 ] * m[ 11 ] )
+	);
+}
+
+inline void Affine3f::print()
+{
+	printf( "[ %.4f %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f %.4f ]\n",
+		m_elements[ 0 ], m_elements[ 3 ], m_elements[ 6 ], m_elements[ 9 ],
+		m_elements[ 1 ], m_elements[ 4 ], m_elements[ 7 ], m_elements[ 10 ],
+		m_elements[ 2 ], m_elements[ 5 ], m_elements[ 8 ], m_elements[ 11 ] );
+}
+
+// static
+inline Affine3f Affine3f::identity()
+{
+	return Affine3f();
+}
+
+// static
+inline Affine3f Affine3f::translation( const Vector3f& rTranslation )
+{
+	return Affine3f
+	(
+		1, 0, 0, rTranslation.x(),
+		0, 1, 0, rTranslation.y(),
+		0, 0, 1, rTranslation.z()
+	);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Operators
+//////////////////////////////////////////////////////////////////////////
+
+inline Affine3f operator * ( const Affine3f& x, const Affine3f& y )
+{
+	const float x00 = x( 0, 0 ), x01 = x( 0, 1 ), x02 = x( 0, 2 ), x03 = x( 0, 3 );
+	const float x10 = x( 1, 0 ), x11 = x( 1, 1 ), x12 = x( 1, 2 ), x13 = x( 1, 3 );
+	const float x20 = x( 2, 0 ), x21 = x( 2, 1 ), x22 = x( 2, 2 ), x23 = x( 2, 3 );
+
+	// y's implicit bottom row ( 0 0 0 1 ) picks up x's translation
+	return Affine3f
+	(
+		x00 * y( 0, 0 ) + x01 * y( 1, 0 ) + x02 * y( 2, 0 ),
+		x00 * y( 0, 1 ) + x01 * y( 1, 1 ) + x02 * y( 2, 1 ),
+		x00 * y( 0, 2 ) + x01 * y( 1, 2 ) + x02 * y( 2, 2 ),
+		x00 * y( 0, 3 ) + x01 * y( 1, 3 ) + x02 * y( 2, 3 ) + x03,
+
+		x10 * y( 0, 0 ) + x11 * y( 1, 0 ) + x12 * y( 2, 0 ),
+		x10 * y( 0, 1 ) + x11 * y( 1, 1 ) + x12 * y( 2, 1 ),
+		x10 * y( 0, 2 ) + x11 * y( 1, 2 ) + x12 * y( 2, 2 ),
+		x10 * y( 0, 3 ) + x11 * y( 1, 3 ) + x12 * y( 2, 3 ) + x13,
+
+		x20 * y( 0, 0 ) + x21 * y( 1, 0 ) + x22 * y( 2, 0 ),
+		x20 * y( 0, 1 ) + x21 * y( 1, 1 ) + x22 * y( 2, 1 ),
+		x20 * y( 0, 2 ) + x21 * y( 1, 2 ) + x22 * y( 2, 2 ),
+		x20 * y( 0, 3 ) + x21 * y( 1, 3 ) + x22 * y( 2, 3 ) + x23
+	);
+}
+
+#endif // AFFINE3F_H
@@ -0,0 +1,140 @@
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+// IEEE 754 half precision float (1 sign, 5 exponent, 10 mantissa bits),
+// for storage only: there is no arithmetic, values are widened to float
+// to work on them and narrowed back to store them.  Good to about three
+// decimal digits, with a largest finite value of 65504.
+class Half
+{
+public:
+
+	constexpr Half();
+
+	// narrowing, rounding to nearest even; out of range values become
+	// infinite
+	explicit Half( float f );
+
+	// widening, which is exact
+	explicit operator float() const;
+	explicit operator double() const;
+
+	// the raw bits
+	constexpr uint16_t bits() const;
+	static constexpr Half fromBits( uint16_t bits );
+
+private:
+
+	uint16_t m_bits;
+
+};
+
+constexpr Half::Half()
+	: m_bits( 0 )
+{
+}
+
+inline Half::Half( float f )
+{
+	uint32_t bits;
+	memcpy( &bits, &f, sizeof( bits ) );
+
+	uint32_t sign = ( bits >> 16 ) & 0x8000;
+	uint32_t magnitude = bits & 0x7fffffff;
+
+	if( magnitude >= 0x7f800000 )
+	{
+		// infinity, or a quiet NaN
+		m_bits = uint16_t( sign | 0x7c00 | ( magnitude > 0x7f800000 ? 0x200 : 0 ) );
+	}
+	else if( magnitude >= 0x477ff000 )
+	{
+		// 65520 and up round past 65504
+		m_bits = uint16_t( sign | 0x7c00 );
+	}
+	else if( magnitude >= 0x38800000 )
+	{
+		// normal: rebias the exponent from 127 to 15 and round off 13
+		// mantissa bits, which may carry into the exponent
+		uint32_t rebiased = magnitude - 0x38000000;
+		uint32_t half = rebiased >> 13;
+		uint32_t remainder = rebiased & 0x1fff;
+		if( remainder > 0x1000 || ( remainder == 0x1000 && ( half & 1 ) ) )
+		{
+			++half;
+		}
+		m_bits = uint16_t( sign | half );
+	}
+	else if( magnitude > 0x33000000 )
+	{
+		// subnormal: the mantissa with its implicit bit in units of 2^-24
+		uint32_t exponent = magnitude >> 23;
+		uint32_t mantissa = ( magnitude & 0x7fffff ) | 0x800000;
+		uint32_t shift = 126 - exponent;
+
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ( ( 1u << shift ) - 1 );
+		uint32_t halfway = 1u << ( shift - 1 );
+		if( remainder > halfway || ( remainder == halfway && ( half & 1 ) ) )
+		{
+			++half;
+		}
+		m_bits = uint16_t( sign | half );
+	}
+	else
+	{
+		// 2^-25 and below round to 0
+		m_bits = uint16_t( sign );
+	}
+}
+
+inline Half::operator float() const
+{
+	uint32_t sign = uint32_t( m_bits & 0x8000 ) << 16;
+	uint32_t exponent = ( m_bits >> 10 ) & 0x1f;
+	uint32_t mantissa = m_bits & 0x3ff;
+
+	if( exponent == 0 )
+	{
+		// zero or subnormal, mantissa * 2^-24
+		float f = mantissa * ( 1.0f / 16777216.0f );
+		return sign ? -f : f;
+	}
+
+	uint32_t bits;
+	if( exponent == 31 )
+	{
+		bits = sign | 0x7f800000 | ( mantissa << 13 );
+	}
+	else
+	{
+		bits = sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 );
+	}
+
+	float f;
+	memcpy( &f, &bits, sizeof( f ) );
+	return f;
+}
+
+inline Half::operator double() const
+{
+	return static_cast< float >( *this );
+}
+
+constexpr uint16_t Half::bits() const
+{
+	return m_bits;
+}
+
+// static
+constexpr Half Half::fromBits( uint16_t bits )
+{
+	Half h;
+	h.m_bits = bits;
+	return h;
+}
+
+#endif // HALF_H
@@ -1,4 +1,87 @@
-#include "Matrix3f.h"
+#ifndef MATRIX3F_H
+#define MATRIX3F_H
+
+#include <cstdio>
+
+class Matrix2f;
+class Quat4f;
+class Vector3f;
+
+// 3x3 Matrix, stored in column major order (OpenGL style)
+class Matrix3f
+{
+public:
+
+    // Fill a 3x3 matrix with "fill", default to 0.
+	Matrix3f( float fill = 0.f );
+	constexpr Matrix3f( float m00, float m01, float m02,
+		float m10, float m11, float m12,
+		float m20, float m21, float m22 );
+
+	// setColumns = true ==> sets the columns of the matrix to be [v0 v1 v2]
+	// otherwise, sets the rows
+	Matrix3f( const Vector3f& v0, const Vector3f& v1, const Vector3f& v2, bool setColumns = true );
+
+	Matrix3f( const Matrix3f& rm ) = default; // copy constructor
+	Matrix3f& operator = ( const Matrix3f& rm ) = default; // assignment operator
+	// no destructor necessary
+
+	constexpr const float& operator () ( int i, int j ) const;
+	constexpr float& operator () ( int i, int j );
+
+	Vector3f getRow( int i ) const;
+	void setRow( int i, const Vector3f& v );
+
+	Vector3f getCol( int j ) const;
+	void setCol( int j, const Vector3f& v );
+
+	// gets the 2x2 submatrix of this matrix to m
+	// starting with upper left corner at (i0, j0)
+	Matrix2f getSubmatrix2x2( int i0, int j0 ) const;
+
+	// sets a 2x2 submatrix of this matrix to m
+	// starting with upper left corner at (i0, j0)
+	void setSubmatrix2x2( int i0, int j0, const Matrix2f& m );
+
+	float determinant() const;
+	Matrix3f inverse( bool* pbIsSingular = NULL, float epsilon = 0.f ) const; // TODO: invert in place as well
+
+	void transpose();
+	Matrix3f transposed() const;
+
+	// ---- Utility ----
+	operator float* (); // automatic type conversion for GL
+	void print();
+
+	static float determinant3x3( float m00, float m01, float m02,
+		float m10, float m11, float m12,
+		float m20, float m21, float m22 );
+
+	static Matrix3f ones();
+	static Matrix3f identity();
+	static Matrix3f rotateX( float radians );
+	static Matrix3f rotateY( float radians );
+	static Matrix3f rotateZ( float radians );
+	static Matrix3f scaling( float sx, float sy, float sz );
+	static Matrix3f uniformScaling( float s );
+	static Matrix3f rotation( const Vector3f& rDirection, float radians );
+
+	// Returns the rotation matrix represented by a unit quaternion
+	// if q is not normalized, it it normalized first
+	static Matrix3f rotation( const Quat4f& rq );
+
+private:
+
+	float m_elements[ 9 ];
+
+};
+
+// Matrix-Vector multiplication
+// 3x3 * 3x1 ==> 3x1
+Vector3f operator * ( const Matrix3f& m, const Vector3f& v );
+
+// Matrix-Matrix multiplication
+Matrix3f operator * ( const Matrix3f& x, const Matrix3f& y );
 
 #include <cassert>
 #include <cmath>
@@ -9,7 +92,7 @@
 #include "Quat4f.h"
 #include "Vector3f.h"
 
-Matrix3f::Matrix3f( float fill )
+inline Matrix3f::Matrix3f( float fill )
 {
 	for( int i = 0; i < 9; ++i )
 	{
@@ -17,24 +100,14 @@ Matrix3f::Matrix3f( float fill )
 	}
 }
 
-Matrix3f::Matrix3f( float m00, float m01, float m02,
+constexpr Matrix3f::Matrix3f( float m00, float m01, float m02,
 				   float m10, float m11, float m12,
 				   float m20, float m21, float m22 )
+	: m_elements{ m00, m10, m20, m01, m11, m21, m02, m12, m22 }
 {
-	m_elements[ 0 ] = m00;
-	m_elements[ 1 ] = m10;
-	m_elements[ 2 ] = m20;
-
-	m_elements[ 3 ] = m01;
-	m_elements[ 4 ] = m11;
-	m_elements[ 5 ] = m21;
-
-	m_elements[ 6 ] = m02;
-	m_elements[ 7 ] = m12;
-	m_elements[ 8 ] = m22;
 }
 
-Matrix3f::Matrix3f( const Vector3f& v0, const Vector3f& v1, const Vector3f& v2, bool setColumns )
+inline Matrix3f::Matrix3f( const Vector3f& v0, const Vector3f& v1, const Vector3f& v2, bool setColumns )
 {
 	if( setColumns )
 	{
@@ -50,31 +123,17 @@ Matrix3f::Matrix3f( const Vector3f& v0, const Vector3f& v1, const Vector3f& v2,
 	}
 }
 
-Matrix3f::Matrix3f( const Matrix3f& rm )
-{
-	memcpy( m_elements, rm.m_elements, 9 * sizeof( float ) );
-}
-
-Matrix3f& Matrix3f::operator = ( const Matrix3f& rm )
-{
-	if( this != &rm )
-	{
-		memcpy( m_elements, rm.m_elements, 9 * sizeof( float ) );
-	}
-	return *this;
-}
-
-const float& Matrix3f::operator () ( int i, int j ) const
+constexpr const float& Matrix3f::operator () ( int i, int j ) const
 {
 	return m_elements[ j * 3 + i ];
 }
 
-float& Matrix3f::operator () ( int i, int j )
+constexpr float& Matrix3f::operator () ( int i, int j )
 {
 	return m_elements[ j * 3 + i ];
 }
 
-Vector3f Matrix3f::getRow( int i ) const
+inline Vector3f Matrix3f::getRow( int i ) const
 {
 	return Vector3f
 	(
@@ -84,14 +143,14 @@ Vector3f Matrix3f::getRow( int i ) const
 	);
 }
 
-void Matrix3f::setRow( int i, const Vector3f& v )
+inline void Matrix3f::setRow( int i, const Vector3f& v )
 {
 	m_elements[ i ] = v.x();
 	m_elements[ i + 3 ] = v.y();
 	m_elements[ i + 6 ] = v.z();
 }
 
-Vector3f Matrix3f::getCol( int j ) const
+inline Vector3f Matrix3f::getCol( int j ) const
 {
 	int colStart = 3 * j;
 
@@ -103,7 +162,7 @@ Vector3f Matrix3f::getCol( int j ) const
 	);
 }
 
-void Matrix3f::setCol( int j, const Vector3f& v )
+inline void Matrix3f::setCol( int j, const Vector3f& v )
 {
 	int colStart = 3 * j;
 
@@ -112,7 +171,7 @@ void Matrix3f::setCol( int j, const Vector3f& v )
 	m_elements[ colStart + 2 ] = v.z();
 }
 
-Matrix2f Matrix3f::getSubmatrix2x2( int i0, int j0 ) const
+inline Matrix2f Matrix3f::getSubmatrix2x2( int i0, int j0 ) const
 {
 	Matrix2f out;
 
@@ -127,7 +186,7 @@ Matrix2f Matrix3f::getSubmatrix2x2( int i0, int j0 ) const
 	return out;
 }
 
-void Matrix3f::setSubmatrix2x2( int i0, int j0, const Matrix2f& m )
+inline void Matrix3f::setSubmatrix2x2( int i0, int j0, const Matrix2f& m )
 {
 	for( int i = 0; i < 2; ++i )
 	{
@@ -138,7 +197,7 @@ void Matrix3f::setSubmatrix2x2( int i0, int j0, const Matrix2f& m )
 	}
 }
 
-float Matrix3f::determinant() const
+inline float Matrix3f::determinant() const
 {
 	return Matrix3f::determinant3x3
 	(
@@ -148,7 +207,7 @@ float Matrix3f::determinant() const
 	);
 }
 
-Matrix3f Matrix3f::inverse( bool* pbIsSingular, float epsilon ) const
+inline Matrix3f Matrix3f::inverse( bool* pbIsSingular, float epsilon ) const
 {
 	float m00 = m_elements[ 0 ];
 	float m10 = m_elements[ 1 ];
@@ -203,7 +262,7 @@ Matrix3f Matrix3f::inverse( bool* pbIsSingular, float epsilon ) const
 	}
 }
 
-void Matrix3f::transpose()
+inline void Matrix3f::transpose()
 {
 	float temp;
 
@@ -218,7 +277,7 @@ void Matrix3f::transpose()
 	}
 }
 
-Matrix3f Matrix3f::transposed() const
+inline Matrix3f Matrix3f::transposed() const
 {
 	Matrix3f out;
 	for( int i = 0; i < 3; ++i )
@@ -232,12 +291,12 @@ Matrix3f Matrix3f::transposed() const
 	return out;
 }
 
-Matrix3f::operator float* ()
+inline Matrix3f::operator float* ()
 {
 	return m_elements;
 }
 
-void Matrix3f::print()
+inline void Matrix3f::print()
 {
 	printf( "[ %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f ]\n",
 		m_elements[ 0 ], m_elements[ 3 ], m_elements[ 6 ],
@@ -246,7 +305,7 @@ void Matrix3f::print()
 }
 
 // static
-float Matrix3f::determinant3x3( float m00, float m01, float m02,
+inline float Matrix3f::determinant3x3( float m00, float m01, float m02,
 							   float m10, float m11, float m12,
 							   float m20, float m21, float m22 )
 {
@@ -259,7 +318,7 @@ float Matrix3f::determinant3x3( float m00, float m01, float m02,
 }
 
 // static
-Matrix3f Matrix3f::ones()
+inline Matrix3f Matrix3f::ones()
 {
 	Matrix3f m;
 	for( int i = 0; i < 9; ++i )
@@ -271,7 +330,7 @@ Matrix3f Matrix3f::ones()
 }
 
 // static
-Matrix3f Matrix3f::identity()
+inline Matrix3f Matrix3f::identity()
 {
 	Matrix3f m;
 
@@ -282,9 +341,8 @@ Matrix3f Matrix3f::identity()
 	return m;
 }
 
-
 // static
-Matrix3f Matrix3f::rotateX( float radians )
+inline Matrix3f Matrix3f::rotateX( float radians )
 {
 	float c = cos( radians );
 	float s = sin( radians );
@@ -298,7 +356,7 @@ Matrix3f Matrix3f::rotateX( float radians )
 }
 
 // static
-Matrix3f Matrix3f::rotateY( float radians )
+inline Matrix3f Matrix3f::rotateY( float radians )
 {
 	float c = cos( radians );
 	float s = sin( radians );
@@ -312,7 +370,7 @@ Matrix3f Matrix3f::rotateY( float radians )
 }
 
 // static
-Matrix3f Matrix3f::rotateZ( float radians )
+inline Matrix3f Matrix3f::rotateZ( float radians )
 {
 	float c = cos( radians );
 	float s = sin( radians );
@@ -326,7 +384,7 @@ Matrix3f Matrix3f::rotateZ( float radians )
 }
 
 // static
-Matrix3f Matrix3f::scaling( float sx, float sy, float sz )
+inline Matrix3f Matrix3f::scaling( float sx, float sy, float sz )
 {
 	return Matrix3f
 	(
@@ -337,7 +395,7 @@ Matrix3f Matrix3f::scaling( float sx, float sy, float sz )
 }
 
 // static
-Matrix3f Matrix3f::uniformScaling( float s )
+inline Matrix3f Matrix3f::uniformScaling( float s )
 {
 	return Matrix3f
 	(
@@ -348,7 +406,7 @@ Matrix3f Matrix3f::uniformScaling( float s )
 }
 
 // static
-Matrix3f Matrix3f::rotation( const Vector3f& rDirection, float radians )
+inline Matrix3f Matrix3f::rotation( const Vector3f& rDirection, float radians )
 {
 	Vector3f normalizedDirection = rDirection.normalized();
 	
@@ -368,7 +426,7 @@ Matrix3f Matrix3f::rotation( const Vector3f& rDirection, float radians )
 }
 
 // static
-Matrix3f Matrix3f::rotation( const Quat4f& rq )
+inline Matrix3f Matrix3f::rotation( const Quat4f& rq )
 {
 	Quat4f q = rq.normalized();
 
@@ -397,7 +455,7 @@ Matrix3f Matrix3f::rotation( const Quat4f& rq )
 // Operators
 //////////////////////////////////////////////////////////////////////////
 
-Vector3f operator * ( const Matrix3f& m, const Vector3f& v )
+inline Vector3f operator * ( const Matrix3f& m, const Vector3f& v )
 {
 	Vector3f output( 0, 0, 0 );
 
@@ -412,7 +470,7 @@ Vector3f operator * ( const Matrix3f& m, const Vector3f& v )
 	return output;
 }
 
-Matrix3f operator * ( const Matrix3f& x, const Matrix3f& y )
+inline Matrix3f operator * ( const Matrix3f& x, const Matrix3f& y )
 {
 	Matrix3f product; // zeroes
 
@@ -429,3 +487,5 @@ Matrix3f operator * ( const Matrix3f& x, const Matrix3f& y )
 
 	return product;
 }
+
+#endif // MATRIX3F_H
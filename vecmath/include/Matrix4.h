@@ -0,0 +1,368 @@
+#ifndef MATRIX_4_H
+#define MATRIX_4_H
+
+#include <cstddef>
+
+class Matrix4f;
+template< typename T > class Quat;
+template< typename T > class Vector3;
+
+// A 4x4 matrix with elements of type T, stored column major like
+// Matrix4f.  Matrix4f, with its SIMD paths, stays the matrix used
+// everywhere; Matrix4d is for composing long chains of transforms, as
+// down a skeleton, where float round off adds up.  The result is
+// narrowed back with an explicit conversion once it's composed.
+template< typename T >
+class Matrix4
+{
+public:
+
+	// the zero matrix
+	constexpr Matrix4();
+
+	// element by element, row by row
+	constexpr Matrix4( T m00, T m01, T m02, T m03,
+		T m10, T m11, T m12, T m13,
+		T m20, T m21, T m22, T m23,
+		T m30, T m31, T m32, T m33 );
+
+	// widening or narrowing from another precision
+	template< typename U >
+	explicit Matrix4( const Matrix4< U >& m );
+
+	explicit Matrix4( const Matrix4f& m );
+	explicit operator Matrix4f() const;
+
+	constexpr const T& operator () ( int i, int j ) const;
+	constexpr T& operator () ( int i, int j );
+
+	Vector3< T > transformPoint( const Vector3< T >& p ) const;
+	Vector3< T > transformVector( const Vector3< T >& v ) const;
+
+	// inverses as in Matrix4f: inverse is general, affineInverse needs
+	// the last row to be [ 0 0 0 1 ] and rigidInverse also needs the
+	// upper 3x3 to be a rotation
+	Matrix4 inverse( bool* pbIsSingular = NULL, T epsilon = 0 ) const;
+	Matrix4 affineInverse( bool* pbIsSingular = NULL, T epsilon = 0 ) const;
+	Matrix4 rigidInverse() const;
+
+	Matrix4 transposed() const;
+
+	static Matrix4 identity();
+	static Matrix4 translation( const Vector3< T >& rTranslation );
+	static Matrix4 rotation( const Quat< T >& q );
+
+private:
+
+	T m_elements[ 16 ];
+
+};
+
+typedef Matrix4< double > Matrix4d;
+
+// matrix product
+template< typename T >
+Matrix4< T > operator * ( const Matrix4< T >& x, const Matrix4< T >& y );
+
+#include <cmath>
+
+#include "Matrix4f.h"
+#include "Quat.h"
+#include "Vector3.h"
+
+template< typename T >
+constexpr Matrix4< T >::Matrix4()
+	: m_elements{}
+{
+}
+
+template< typename T >
+constexpr Matrix4< T >::Matrix4( T m00, T m01, T m02, T m03,
+	T m10, T m11, T m12, T m13,
+	T m20, T m21, T m22, T m23,
+	T m30, T m31, T m32, T m33 )
+	: m_elements{ m00, m10, m20, m30, m01, m11, m21, m31, m02, m12, m22, m32, m03, m13, m23, m33 }
+{
+}
+
+template< typename T >
+template< typename U >
+inline Matrix4< T >::Matrix4( const Matrix4< U >& m )
+{
+	for( int i = 0; i < 4; ++i )
+	{
+		for( int j = 0; j < 4; ++j )
+		{
+			( *this )( i, j ) = static_cast< T >( m( i, j ) );
+		}
+	}
+}
+
+template< typename T >
+inline Matrix4< T >::Matrix4( const Matrix4f& m )
+{
+	for( int i = 0; i < 4; ++i )
+	{
+		for( int j = 0; j < 4; ++j )
+		{
+			( *this )( i, j ) = static_cast< T >( m( i, j ) );
+		}
+	}
+}
+
+template< typename T >
+inline Matrix4< T >::operator Matrix4f() const
+{
+	Matrix4f m;
+	for( int i = 0; i < 4; ++i )
+	{
+		for( int j = 0; j < 4; ++j )
+		{
+			m( i, j ) = static_cast< float >( ( *this )( i, j ) );
+		}
+	}
+	return m;
+}
+
+template< typename T >
+constexpr const T& Matrix4< T >::operator () ( int i, int j ) const
+{
+	return m_elements[ j * 4 + i ];
+}
+
+template< typename T >
+constexpr T& Matrix4< T >::operator () ( int i, int j )
+{
+	return m_elements[ j * 4 + i ];
+}
+
+template< typename T >
+inline Vector3< T > Matrix4< T >::transformPoint( const Vector3< T >& p ) const
+{
+	const T* m = m_elements;
+	return Vector3< T >
+		(
+			m[ 0 ] * p[ 0 ] + m[ 4 ] * p[ 1 ] + m[ 8 ] * p[ 2 ] + m[ 12 ],
+			m[ 1 ] * p[ 0 ] + m[ 5 ] * p[ 1 ] + m[ 9 ] * p[ 2 ] + m[ 13 ],
+			m[ 2 ] * p[ 0 ] + m[ 6 ] * p[ 1 ] + m[ 10 ] * p[ 2 ] + m[ 14 ]
+		);
+}
+
+template< typename T >
+inline Vector3< T > Matrix4< T >::transformVector( const Vector3< T >& v ) const
+{
+	const T* m = m_elements;
+	return Vector3< T >
+		(
+			m[ 0 ] * v[ 0 ] + m[ 4 ] * v[ 1 ] + m[ 8 ] * v[ 2 ],
+			m[ 1 ] * v[ 0 ] + m[ 5 ] * v[ 1 ] + m[ 9 ] * v[ 2 ],
+			m[ 2 ] * v[ 0 ] + m[ 6 ] * v[ 1 ] + m[ 10 ] * v[ 2 ]
+		);
+}
+
+template< typename T >
+inline Matrix4< T > Matrix4< T >::inverse( bool* pbIsSingular, T epsilon ) const
+{
+	const T* m = m_elements;
+
+	// 2x2 determinants of the two left and the two right columns
+	T s0 = m[ 0 ] * m[ 5 ] - m[ 1 ] * m[ 4 ];
+	T s1 = m[ 0 ] * m[ 6 ] - m[ 2 ] * m[ 4 ];
+	T s2 = m[ 0 ] * m[ 7 ] - m[ 3 ] * m[ 4 ];
+	T s3 = m[ 1 ] * m[ 6 ] - m[ 2 ] * m[ 5 ];
+	T s4 = m[ 1 ] * m[ 7 ] - m[ 3 ] * m[ 5 ];
+	T s5 = m[ 2 ] * m[ 7 ] - m[ 3 ] * m[ 6 ];
+
+	T c5 = m[ 10 ] * m[ 15 ] - m[ 11 ] * m[ 14 ];
+	T c4 = m[ 9 ] * m[ 15 ] - m[ 11 ] * m[ 13 ];
+	T c3 = m[ 9 ] * m[ 14 ] - m[ 10 ] * m[ 13 ];
+	T c2 = m[ 8 ] * m[ 15 ] - m[ 11 ] * m[ 12 ];
+	T c1 = m[ 8 ] * m[ 14 ] - m[ 10 ] * m[ 12 ];
+	T c0 = m[ 8 ] * m[ 13 ] - m[ 9 ] * m[ 12 ];
+
+	T determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+	bool isSingular = ( std::abs( determinant ) <= epsilon );
+	if( pbIsSingular != NULL )
+	{
+		*pbIsSingular = isSingular;
+	}
+
+	if( isSingular )
+	{
+		return Matrix4();
+	}
+
+	T r = T( 1 ) / determinant;
+
+	Matrix4 out;
+	T* o = out.m_elements;
+
+	o[ 0 ] = ( m[ 5 ] * c5 - m[ 6 ] * c4 + m[ 7 ] * c3 ) * r;
+	o[ 1 ] = ( -m[ 1 ] * c5 + m[ 2 ] * c4 - m[ 3 ] * c3 ) * r;
+	o[ 2 ] = ( m[ 13 ] * s5 - m[ 14 ] * s4 + m[ 15 ] * s3 ) * r;
+	o[ 3 ] = ( -m[ 9 ] * s5 + m[ 10 ] * s4 - m[ 11 ] * s3 ) * r;
+
+	o[ 4 ] = ( -m[ 4 ] * c5 + m[ 6 ] * c2 - m[ 7 ] * c1 ) * r;
+	o[ 5 ] = ( m[ 0 ] * c5 - m[ 2 ] * c2 + m[ 3 ] * c1 ) * r;
+	o[ 6 ] = ( -m[ 12 ] * s5 + m[ 14 ] * s2 - m[ 15 ] * s1 ) * r;
+	o[ 7 ] = ( m[ 8 ] * s5 - m[ 10 ] * s2 + m[ 11 ] * s1 ) * r;
+
+	o[ 8 ] = ( m[ 4 ] * c4 - m[ 5 ] * c2 + m[ 7 ] * c0 ) * r;
+	o[ 9 ] = ( -m[ 0 ] * c4 + m[ 1 ] * c2 - m[ 3 ] * c0 ) * r;
+	o[ 10 ] = ( m[ 12 ] * s4 - m[ 13 ] * s2 + m[ 15 ] * s0 ) * r;
+	o[ 11 ] = ( -m[ 8 ] * s4 + m[ 9 ] * s2 - m[ 11 ] * s0 ) * r;
+
+	o[ 12 ] = ( -m[ 4 ] * c3 + m[ 5 ] * c1 - m[ 6 ] * c0 ) * r;
+	o[ 13 ] = ( m[ 0 ] * c3 - m[ 1 ] * c1 + m[ 2 ] * c0 ) * r;
+	o[ 14 ] = ( -m[ 12 ] * s3 + m[ 13 ] * s1 - m[ 14 ] * s0 ) * r;
+	o[ 15 ] = ( m[ 8 ] * s3 - m[ 9 ] * s1 + m[ 10 ] * s0 ) * r;
+
+	return out;
+}
+
+template< typename T >
+inline Matrix4< T > Matrix4< T >::affineInverse( bool* pbIsSingular, T epsilon ) const
+{
+	const T* m = m_elements;
+
+	// cofactors of the upper 3x3
+	T cofactor00 = m[ 5 ] * m[ 10 ] - m[ 9 ] * m[ 6 ];
+	T cofactor01 = m[ 9 ] * m[ 2 ] - m[ 1 ] * m[ 10 ];
+	T cofactor02 = m[ 1 ] * m[ 6 ] - m[ 5 ] * m[ 2 ];
+	T cofactor10 = m[ 8 ] * m[ 6 ] - m[ 4 ] * m[ 10 ];
+	T cofactor11 = m[ 0 ] * m[ 10 ] - m[ 8 ] * m[ 2 ];
+	T cofactor12 = m[ 4 ] * m[ 2 ] - m[ 0 ] * m[ 6 ];
+	T cofactor20 = m[ 4 ] * m[ 9 ] - m[ 8 ] * m[ 5 ];
+	T cofactor21 = m[ 8 ] * m[ 1 ] - m[ 0 ] * m[ 9 ];
+	T cofactor22 = m[ 0 ] * m[ 5 ] - m[ 4 ] * m[ 1 ];
+
+	T determinant = m[ 0 ] * cofactor00 + m[ 4 ] * cofactor01 + m[ 8 ] * cofactor02;
+
+	bool isSingular = ( std::abs( determinant ) <= epsilon );
+	if( pbIsSingular != NULL )
+	{
+		*pbIsSingular = isSingular;
+	}
+
+	if( isSingular )
+	{
+		return Matrix4();
+	}
+
+	T r = T( 1 ) / determinant;
+	T i00 = cofactor00 * r, i01 = cofactor10 * r, i02 = cofactor20 * r;
+	T i10 = cofactor01 * r, i11 = cofactor11 * r, i12 = cofactor21 * r;
+	T i20 = cofactor02 * r, i21 = cofactor12 * r, i22 = cofactor22 * r;
+
+	return Matrix4
+	(
+		i00, i01, i02, -( i00 * m[ 12 ] + i01 * m[ 13 ] + i02 * m[ 14 ] ),
+		i10, i11, i12, -( i10 * m[ 12 ] + i11 * m[ 13 ] + i12 * m[ 14 ] ),
+		i20, i21, i22, -( i20 * m[ 12 ] + i21 * m[ 13 ] + i22 * m[ 14 ] ),
+		0, 0, 0, 1
+	);
+}
+
+template< typename T >
+inline Matrix4< T > Matrix4< T >::rigidInverse() const
+{
+	const T* m = m_elements;
+
+	// the rows of the rotation are the columns of its transpose
+	return Matrix4
+	(
+		m[ 0 ], m[ 1 ], m[ 2 ], -( m[ 0 ] * m[ 12 ] + m[ 1 ] * m[ 13 ] + m[ 2 ] * m[ 14 ] ),
+		m[ 4 ], m[ 5 ], m[ 6 ], -( m[ 4 ] * m[ 12 ] + m[ 5 ] * m[ 13 ] + m[ 6 ] * m[ 14 ] ),
+		m[ 8 ], m[ 9 ], m[ 10 ], -( m[ 8 ] * m[ 12 ] + m[ 9 ] * m[ 13 ] + m[ 10 ] * m[ 14 ] ),
+		0, 0, 0, 1
+	);
+}
+
+template< typename T >
+inline Matrix4< T > Matrix4< T >::transposed() const
+{
+	Matrix4 out;
+	for( int i = 0; i < 4; ++i )
+	{
+		for( int j = 0; j < 4; ++j )
+		{
+			out( j, i ) = ( *this )( i, j );
+		}
+	}
+	return out;
+}
+
+// static
+template< typename T >
+inline Matrix4< T > Matrix4< T >::identity()
+{
+	return Matrix4
+	(
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1
+	);
+}
+
+// static
+template< typename T >
+inline Matrix4< T > Matrix4< T >::translation( const Vector3< T >& rTranslation )
+{
+	return Matrix4
+	(
+		1, 0, 0, rTranslation[ 0 ],
+		0, 1, 0, rTranslation[ 1 ],
+		0, 0, 1, rTranslation[ 2 ],
+		0, 0, 0, 1
+	);
+}
+
+// static
+template< typename T >
+inline Matrix4< T > Matrix4< T >::rotation( const Quat< T >& rq )
+{
+	Quat< T > q = rq.normalized();
+
+	T xx = q.x() * q.x();
+	T yy = q.y() * q.y();
+	T zz = q.z() * q.z();
+
+	T xy = q.x() * q.y();
+	T zw = q.z() * q.w();
+
+	T xz = q.x() * q.z();
+	T yw = q.y() * q.w();
+
+	T yz = q.y() * q.z();
+	T xw = q.x() * q.w();
+
+	return Matrix4
+	(
+		1 - 2 * ( yy + zz ),	2 * ( xy - zw ),		2 * ( xz + yw ),		0,
+		2 * ( xy + zw ),		1 - 2 * ( xx + zz ),	2 * ( yz - xw ),		0,
+		2 * ( xz - yw ),		2 * ( yz + xw ),		1 - 2 * ( xx + yy ),	0,
+		0,						0,						0,						1
+	);
+}
+
+template< typename T >
+inline Matrix4< T > operator * ( const Matrix4< T >& x, const Matrix4< T >& y )
+{
+	Matrix4< T > product;
+
+	// column j of the product is x times column j of y
+	for( int j = 0; j < 4; ++j )
+	{
+		T y0 = y( 0, j ), y1 = y( 1, j ), y2 = y( 2, j ), y3 = y( 3, j );
+		for( int i = 0; i < 4; ++i )
+		{
+			product( i, j ) = x( i, 0 ) * y0 + x( i, 1 ) * y1 + x( i, 2 ) * y2 + x( i, 3 ) * y3;
+		}
+	}
+
+	return product;
+}
+
+#endif // MATRIX_4_H
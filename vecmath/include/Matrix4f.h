@@ -0,0 +1,814 @@
+#ifndef MATRIX4F_H
+#define MATRIX4F_H
+
+#include <cstddef>
+#include <cstdio>
+
+class Matrix2f;
+class Matrix3f;
+class Quat4f;
+class Vector3f;
+class Vector4f;
+
+// 4x4 Matrix, stored in column major order (OpenGL style)
+class Matrix4f
+{
+public:
+
+    // Fill a 4x4 matrix with "fill".  Default to 0.
+	Matrix4f( float fill = 0.f );
+	constexpr Matrix4f( float m00, float m01, float m02, float m03,
+		float m10, float m11, float m12, float m13,
+		float m20, float m21, float m22, float m23,
+		float m30, float m31, float m32, float m33 );
+	
+	// setColumns = true ==> sets the columns of the matrix to be [v0 v1 v2 v3]
+	// otherwise, sets the rows
+	Matrix4f( const Vector4f& v0, const Vector4f& v1, const Vector4f& v2, const Vector4f& v3, bool setColumns = true );
+	
+	Matrix4f( const Matrix4f& rm ) = default; // copy constructor
+	Matrix4f& operator = ( const Matrix4f& rm ) = default; // assignment operator
+	Matrix4f& operator/=(float d);
+	// no destructor necessary
+
+	constexpr const float& operator () ( int i, int j ) const;
+	constexpr float& operator () ( int i, int j );
+
+	Vector4f getRow( int i ) const;
+	void setRow( int i, const Vector4f& v );
+
+	// get column j (mod 4)
+	Vector4f getCol( int j ) const;
+	void setCol( int j, const Vector4f& v );
+
+	// gets the 2x2 submatrix of this matrix to m
+	// starting with upper left corner at (i0, j0)
+	Matrix2f getSubmatrix2x2( int i0, int j0 ) const;
+
+	// gets the 3x3 submatrix of this matrix to m
+	// starting with upper left corner at (i0, j0)
+	Matrix3f getSubmatrix3x3( int i0, int j0 ) const;
+
+	// sets a 2x2 submatrix of this matrix to m
+	// starting with upper left corner at (i0, j0)
+	void setSubmatrix2x2( int i0, int j0, const Matrix2f& m );
+
+	// sets a 3x3 submatrix of this matrix to m
+	// starting with upper left corner at (i0, j0)
+	void setSubmatrix3x3( int i0, int j0, const Matrix3f& m );
+
+	float determinant() const;
+	Matrix4f inverse( bool* pbIsSingular = NULL, float epsilon = 0.f ) const;
+
+	// Inverses for matrices whose bottom row is ( 0 0 0 1 ), which skip
+	// the general cofactor expansion: affineInverse inverts the upper
+	// 3x3 only, and rigidInverse transposes it, so the upper 3x3 must
+	// be a rotation.  affineInverse is singular like inverse when the
+	// upper 3x3 is.
+	Matrix4f affineInverse( bool* pbIsSingular = NULL, float epsilon = 0.f ) const;
+	Matrix4f rigidInverse() const;
+
+	void transpose();
+	Matrix4f transposed() const;
+
+	// ---- Utility ----
+	operator float* (); // automatic type conversion for GL
+	operator const float* () const; // automatic type conversion for GL
+	
+	void print();
+
+	static Matrix4f ones();
+	static Matrix4f identity();
+	static Matrix4f translation( float x, float y, float z );
+	static Matrix4f translation( const Vector3f& rTranslation );
+	static Matrix4f rotateX( float radians );
+	static Matrix4f rotateY( float radians );
+	static Matrix4f rotateZ( float radians );
+	static Matrix4f rotation( const Vector3f& rDirection, float radians );
+	static Matrix4f scaling( float sx, float sy, float sz );
+	static Matrix4f uniformScaling( float s );
+	static Matrix4f lookAt( const Vector3f& eye, const Vector3f& center, const Vector3f& up );
+	static Matrix4f orthographicProjection( float width, float height, float zNear, float zFar, bool directX );
+	static Matrix4f orthographicProjection( float left, float right, float bottom, float top, float zNear, float zFar, bool directX );
+	static Matrix4f perspectiveProjection( float fLeft, float fRight, float fBottom, float fTop, float fZNear, float fZFar, bool directX );
+	static Matrix4f perspectiveProjection( float fovYRadians, float aspect, float zNear, float zFar, bool directX );
+	static Matrix4f infinitePerspectiveProjection( float fLeft, float fRight, float fBottom, float fTop, float fZNear, bool directX );
+
+	// Returns the rotation matrix represented by a quaternion
+	// uses a normalized version of q
+	static Matrix4f rotation( const Quat4f& q );
+
+	// returns an orthogonal matrix that's a uniformly distributed rotation
+	// given u[i] is a uniformly distributed random number in [0,1]
+	static Matrix4f randomRotation( float u0, float u1, float u2 );
+
+private:
+
+	// 16-byte aligned for the SSE and NEON kernels in Simd4f.h
+	alignas( 16 ) float m_elements[ 16 ];
+
+};
+
+// Matrix-Vector multiplication
+// 4x4 * 4x1 ==> 4x1
+Vector4f operator * ( const Matrix4f& m, const Vector4f& v );
+
+// Matrix-Matrix multiplication
+Matrix4f operator * ( const Matrix4f& x, const Matrix4f& y );
+
+// Batch transforms of count points, vectors or normals: points as
+// ( p, 1 ), vectors as ( v, 0 ) and normals by the inverse transpose
+// of the upper 3x3 of m, without renormalizing them.  out may be the
+// input array itself, but must not overlap it otherwise.
+void transformPoints( const Matrix4f& m, const Vector3f* points, Vector3f* out, size_t count );
+void transformVectors( const Matrix4f& m, const Vector3f* vectors, Vector3f* out, size_t count );
+void transformVectors( const Matrix3f& m, const Vector3f* vectors, Vector3f* out, size_t count );
+void transformNormals( const Matrix4f& m, const Vector3f* normals, Vector3f* out, size_t count );
+
+// transformPoints for points stored as separate x, y and z arrays
+void transformPointsSoA( const Matrix4f& m, const float* x, const float* y, const float* z,
+	float* outX, float* outY, float* outZ, size_t count );
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "Matrix2f.h"
+#include "Matrix3f.h"
+#include "Quat4f.h"
+#include "Simd4f.h"
+#include "Vector3f.h"
+#include "Vector4f.h"
+
+inline Matrix4f::Matrix4f( float fill )
+{
+	for( int i = 0; i < 16; ++i )
+	{
+		m_elements[ i ] = fill;
+	}
+}
+
+constexpr Matrix4f::Matrix4f( float m00, float m01, float m02, float m03,
+				   float m10, float m11, float m12, float m13,
+				   float m20, float m21, float m22, float m23,
+				   float m30, float m31, float m32, float m33 )
+	: m_elements{ m00, m10, m20, m30, m01, m11, m21, m31, m02, m12, m22, m32, m03, m13, m23, m33 }
+{
+}
+
+inline Matrix4f& Matrix4f::operator/=(float d)
+{
+	for(int ii=0;ii<16;ii++){
+		m_elements[ii]/=d;
+	}
+	return *this;
+}
+
+inline Matrix4f::Matrix4f( const Vector4f& v0, const Vector4f& v1, const Vector4f& v2, const Vector4f& v3, bool setColumns )
+{
+	if( setColumns )
+	{
+		setCol( 0, v0 );
+		setCol( 1, v1 );
+		setCol( 2, v2 );
+		setCol( 3, v3 );
+	}
+	else
+	{
+		setRow( 0, v0 );
+		setRow( 1, v1 );
+		setRow( 2, v2 );
+		setRow( 3, v3 );
+	}
+}
+
+constexpr const float& Matrix4f::operator () ( int i, int j ) const
+{
+	return m_elements[ j * 4 + i ];
+}
+
+constexpr float& Matrix4f::operator () ( int i, int j )
+{
+	return m_elements[ j * 4 + i ];
+}
+
+inline Vector4f Matrix4f::getRow( int i ) const
+{
+	return Vector4f
+	(
+		m_elements[ i ],
+		m_elements[ i + 4 ],
+		m_elements[ i + 8 ],
+		m_elements[ i + 12 ]
+	);
+}
+
+inline void Matrix4f::setRow( int i, const Vector4f& v )
+{
+	m_elements[ i ] = v.x();
+	m_elements[ i + 4 ] = v.y();
+	m_elements[ i + 8 ] = v.z();
+	m_elements[ i + 12 ] = v.w();
+}
+
+inline Vector4f Matrix4f::getCol( int j ) const
+{
+	int colStart = 4 * j;
+
+	return Vector4f
+	(
+		m_elements[ colStart ],
+		m_elements[ colStart + 1 ],
+		m_elements[ colStart + 2 ],
+		m_elements[ colStart + 3 ]
+	);
+}
+
+inline void Matrix4f::setCol( int j, const Vector4f& v )
+{
+	int colStart = 4 * j;
+
+	m_elements[ colStart ] = v.x();
+	m_elements[ colStart + 1 ] = v.y();
+	m_elements[ colStart + 2 ] = v.z();
+	m_elements[ colStart + 3 ] = v.w();
+}
+
+inline Matrix2f Matrix4f::getSubmatrix2x2( int i0, int j0 ) const
+{
+	Matrix2f out;
+
+	for( int i = 0; i < 2; ++i )
+	{
+		for( int j = 0; j < 2; ++j )
+		{
+			out( i, j ) = ( *this )( i + i0, j + j0 );
+		}
+	}
+
+	return out;
+}
+
+inline Matrix3f Matrix4f::getSubmatrix3x3( int i0, int j0 ) const
+{
+	Matrix3f out;
+
+	for( int i = 0; i < 3; ++i )
+	{
+		for( int j = 0; j < 3; ++j )
+		{
+			out( i, j ) = ( *this )( i + i0, j + j0 );
+		}
+	}
+
+	return out;
+}
+
+inline void Matrix4f::setSubmatrix2x2( int i0, int j0, const Matrix2f& m )
+{
+	for( int i = 0; i < 2; ++i )
+	{
+		for( int j = 0; j < 2; ++j )
+		{
+			( *this )( i + i0, j + j0 ) = m( i, j );
+		}
+	}
+}
+
+inline void Matrix4f::setSubmatrix3x3( int i0, int j0, const Matrix3f& m )
+{
+	for( int i = 0; i < 3; ++i )
+	{
+		for( int j = 0; j < 3; ++j )
+		{
+			( *this )( i + i0, j + j0 ) = m( i, j );
+		}
+	}
+}
+
+inline float Matrix4f::determinant() const
+{
+	float m00 = m_elements[ 0 ];
+	float m10 = m_elements[ 1 ];
+	float m20 = m_elements[ 2 ];
+	float m30 = m_elements[ 3 ];
+
+	float m01 = m_elements[ 4 ];
+	float m11 = m_elements[ 5 ];
+	float m21 = m_elements[ 6 ];
+	float m31 = m_elements[ 7 ];
+
+	float m02 = m_elements[ 8 ];
+	float m12 = m_elements[ 9 ];
+	float m22 = m_elements[ 10 ];
+	float m32 = m_elements[ 11 ];
+
+	float m03 = m_elements[ 12 ];
+	float m13 = m_elements[ 13 ];
+	float m23 = m_elements[ 14 ];
+	float m33 = m_elements[ 15 ];
+
+	float cofactor00 =  Matrix3f::determinant3x3( m11, m12, m13, m21, m22, m23, m31, m32, m33 );
+	float cofactor01 = -Matrix3f::determinant3x3( m12, m13, m10, m22, m23, m20, m32, m33, m30 );
+	float cofactor02 =  Matrix3f::determinant3x3( m13, m10, m11, m23, m20, m21, m33, m30, m31 );
+	float cofactor03 = -Matrix3f::determinant3x3( m10, m11, m12, m20, m21, m22, m30, m31, m32 );
+
+	return( m00 * cofactor00 + m01 * cofactor01 + m02 * cofactor02 + m03 * cofactor03 );
+}
+
+inline Matrix4f Matrix4f::inverse( bool* pbIsSingular, float epsilon ) const
+{
+	Matrix4f out;
+	float determinant = native4f::inverse( m_elements, out.m_elements );
+
+	bool isSingular = ( fabs( determinant ) < epsilon );
+	if( pbIsSingular != NULL )
+	{
+		*pbIsSingular = isSingular;
+	}
+
+	return isSingular ? Matrix4f() : out;
+}
+
+inline Matrix4f Matrix4f::affineInverse( bool* pbIsSingular, float epsilon ) const
+{
+	const float* m = m_elements;
+
+	// cofactors of the upper 3x3
+	float cofactor00 = m[ 5 ] * m[ 10 ] - m[ 9 ] * m[ 6 ];
+	float cofactor01 = m[ 9 ] * m[ 2 ] - m[ 1 ] * m[ 10 ];
+	float cofactor02 = m[ 1 ] * m[ 6 ] - m[ 5 ] * m[ 2 ];
+	float cofactor10 = m[ 8 ] * m[ 6 ] - m[ 4 ] * m[ 10 ];
+	float cofactor11 = m[ 0 ] * m[ 10 ] - m[ 8 ] * m[ 2 ];
+	float cofactor12 = m[ 4 ] * m[ 2 ] - m[ 0 ] * m[ 6 ];
+	float cofactor20 = m[ 4 ] * m[ 9 ] - m[ 8 ] * m[ 5 ];
+	float cofactor21 = m[ 8 ] * m[ 1 ] - m[ 0 ] * m[ 9 ];
+	float cofactor22 = m[ 0 ] * m[ 5 ] - m[ 4 ] * m[ 1 ];
+
+	float determinant = m[ 0 ] * cofactor00 + m[ 4 ] * cofactor01 + m[ 8 ] * cofactor02;
+
+	bool isSingular = ( fabs( determinant ) < epsilon );
+	if( pbIsSingular != NULL )
+	{
+		*pbIsSingular = isSingular;
+	}
+
+	if( isSingular )
+	{
+		return Matrix4f();
+	}
+
+	float r = 1.0f / determinant;
+	float i00 = cofactor00 * r, i01 = cofactor10 * r, i02 = cofactor20 * r;
+	float i10 = cofactor01 * r, i11 = cofactor11 * r, i12 = cofactor21 * r;
+	float i20 = cofactor02 * r, i21 = cofactor12 * r, i22 = cofactor22 * r;
+
+	return Matrix4f
+	(
+		i00, i01, i02, -( i00 * m[ 12 ] + i01 * m[ 13 ] + i02 * m[ 14 ] ),
+		i10, i11, i12, -( i10 * m[ 12 ] + i11 * m[ 13 ] + i12 * m[ 14 ] ),
+		i20, i21, i22, -( i20 * m[ 12 ] + i21 * m[ 13 ] + i22 * m[ 14 ] ),
+		0, 0, 0, 1
+	);
+}
+
+inline Matrix4f Matrix4f::rigidInverse() const
+{
+	const float* m = m_elements;
+
+	// the rows of the rotation are the columns of its transpose
+	return Matrix4f
+	(
+		m[ 0 ], m[ 1 ], m[ 2 ], -( m[ 0 ] * m[ 12 ] + m[ 1 ] * m[ 13 ] + m[ 2 ] * m[ 14 ] ),
+		m[ 4 ], m[ 5 ], m[ 6 ], -( m[ 4 ] * m[ 12 ] + m[ 5 ] * m[ 13 ] + m[ 6 ] * m[ 14 ] ),
+		m[ 8 ], m[ 9 ], m[ 10 ], -( m[ 8 ] * m[ 12 ] + m[ 9 ] * m[ 13 ] + m[ 10 ] * m[ 14 ] ),
+		0, 0, 0, 1
+	);
+}
+
+inline void Matrix4f::transpose()
+{
+	float temp;
+
+	for( int i = 0; i < 3; ++i )
+	{
+		for( int j = i + 1; j < 4; ++j )
+		{
+			temp = ( *this )( i, j );
+			( * this )( i, j ) = ( *this )( j, i );
+			( *this )( j, i ) = temp;
+		}
+	}
+}
+
+inline Matrix4f Matrix4f::transposed() const
+{
+	Matrix4f out;
+	for( int i = 0; i < 4; ++i )
+	{
+		for( int j = 0; j < 4; ++j )
+		{
+			out( j, i ) = ( *this )( i, j );
+		}
+	}
+
+	return out;
+}
+
+inline Matrix4f::operator float* ()
+{
+	return m_elements;
+}
+
+inline Matrix4f::operator const float* ()const
+{
+	return m_elements;
+}
+
+inline void Matrix4f::print()
+{
+	printf( "[ %.4f %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f %.4f ]\n[ %.4f %.4f %.4f %.4f ]\n",
+		m_elements[ 0 ], m_elements[ 4 ], m_elements[ 8 ], m_elements[ 12 ],
+		m_elements[ 1 ], m_elements[ 5 ], m_elements[ 9 ], m_elements[ 13 ],
+		m_elements[ 2 ], m_elements[ 6 ], m_elements[ 10], m_elements[ 14 ],
+		m_elements[ 3 ], m_elements[ 7 ], m_elements[ 11], m_elements[ 15 ] );
+}
+
+// static
+inline Matrix4f Matrix4f::ones()
+{
+	Matrix4f m;
+	for( int i = 0; i < 16; ++i )
+	{
+		m.m_elements[ i ] = 1;
+	}
+
+	return m;
+}
+
+// static
+inline Matrix4f Matrix4f::identity()
+{
+	Matrix4f m;
+	
+	m( 0, 0 ) = 1;
+	m( 1, 1 ) = 1;
+	m( 2, 2 ) = 1;
+	m( 3, 3 ) = 1;
+
+	return m;
+}
+
+// static
+inline Matrix4f Matrix4f::translation( float x, float y, float z )
+{
+	return Matrix4f
+	(
+		1, 0, 0, x,
+		0, 1, 0, y,
+		0, 0, 1, z,
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::translation( const Vector3f& rTranslation )
+{
+	return Matrix4f
+	(
+		1, 0, 0, rTranslation.x(),
+		0, 1, 0, rTranslation.y(),
+		0, 0, 1, rTranslation.z(),
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::rotateX( float radians )
+{
+	float c = cos( radians );
+	float s = sin( radians );
+
+	return Matrix4f
+	(
+		1, 0, 0, 0,
+		0, c, -s, 0,
+		0, s, c, 0,
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::rotateY( float radians )
+{
+	float c = cos( radians );
+	float s = sin( radians );
+
+	return Matrix4f
+	(
+		c, 0, s, 0,
+		0, 1, 0, 0,
+		-s, 0, c, 0,
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::rotateZ( float radians )
+{
+	float c = cos( radians );
+	float s = sin( radians );
+
+	return Matrix4f
+	(
+		c, -s, 0, 0,
+		s, c, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::rotation( const Vector3f& rDirection, float radians )
+{
+	Vector3f normalizedDirection = rDirection.normalized();
+	
+	float cosTheta = cos( radians );
+	float sinTheta = sin( radians );
+
+	float x = normalizedDirection.x();
+	float y = normalizedDirection.y();
+	float z = normalizedDirection.z();
+
+	return Matrix4f
+	(
+		x * x * ( 1.0f - cosTheta ) + cosTheta,			y * x * ( 1.0f - cosTheta ) - z * sinTheta,		z * x * ( 1.0f - cosTheta ) + y * sinTheta,		0.0f,
+		x * y * ( 1.0f - cosTheta ) + z * sinTheta,		y * y * ( 1.0f - cosTheta ) + cosTheta,			z * y * ( 1.0f - cosTheta ) - x * sinTheta,		0.0f,
+		x * z * ( 1.0f - cosTheta ) - y * sinTheta,		y * z * ( 1.0f - cosTheta ) + x * sinTheta,		z * z * ( 1.0f - cosTheta ) + cosTheta,			0.0f,
+		0.0f,											0.0f,											0.0f,											1.0f
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::rotation( const Quat4f& q )
+{
+	Quat4f qq = q.normalized();
+
+	float xx = qq.x() * qq.x();
+	float yy = qq.y() * qq.y();
+	float zz = qq.z() * qq.z();
+
+	float xy = qq.x() * qq.y();
+	float zw = qq.z() * qq.w();
+
+	float xz = qq.x() * qq.z();
+	float yw = qq.y() * qq.w();
+
+	float yz = qq.y() * qq.z();
+	float xw = qq.x() * qq.w();
+
+	return Matrix4f
+	(
+		1.0f - 2.0f * ( yy + zz ),		2.0f * ( xy - zw ),				2.0f * ( xz + yw ),				0.0f,
+		2.0f * ( xy + zw ),				1.0f - 2.0f * ( xx + zz ),		2.0f * ( yz - xw ),				0.0f,
+		2.0f * ( xz - yw ),				2.0f * ( yz + xw ),				1.0f - 2.0f * ( xx + yy ),		0.0f,
+		0.0f,							0.0f,							0.0f,							1.0f
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::scaling( float sx, float sy, float sz )
+{
+	return Matrix4f
+	(
+		sx, 0, 0, 0,
+		0, sy, 0, 0,
+		0, 0, sz, 0,
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::uniformScaling( float s )
+{
+	return Matrix4f
+	(
+		s, 0, 0, 0,
+		0, s, 0, 0,
+		0, 0, s, 0,
+		0, 0, 0, 1
+	);
+}
+
+// static
+inline Matrix4f Matrix4f::randomRotation( float u0, float u1, float u2 )
+{
+	return Matrix4f::rotation( Quat4f::randomRotation( u0, u1, u2 ) );
+}
+
+// static
+inline Matrix4f Matrix4f::lookAt( const Vector3f& eye, const Vector3f& center, const Vector3f& up )
+{
+	// z is negative forward
+	Vector3f z = ( eye - center ).normalized();
+	Vector3f y = up;
+	Vector3f x = Vector3f::cross( y, z );
+
+	// the x, y, and z vectors define the orthonormal coordinate system
+	// the affine part defines the overall translation
+	Matrix4f view;
+
+	view.setRow( 0, Vector4f( x, -Vector3f::dot( x, eye ) ) );
+	view.setRow( 1, Vector4f( y, -Vector3f::dot( y, eye ) ) );
+	view.setRow( 2, Vector4f( z, -Vector3f::dot( z, eye ) ) );
+	view.setRow( 3, Vector4f( 0, 0, 0, 1 ) );
+
+	return view;
+}
+
+// static
+inline Matrix4f Matrix4f::orthographicProjection( float width, float height, float zNear, float zFar, bool directX )
+{
+	Matrix4f m;
+
+	m( 0, 0 ) = 2.0f / width;
+	m( 1, 1 ) = 2.0f / height;
+	m( 3, 3 ) = 1.0f;
+
+	m( 0, 3 ) = -1;
+	m( 1, 3 ) = -1;
+
+	if( directX )
+	{
+		m( 2, 2 ) = 1.0f / ( zNear - zFar );
+		m( 2, 3 ) = zNear / ( zNear - zFar );
+	}
+	else
+	{
+		m( 2, 2 ) = 2.0f / ( zNear - zFar );
+		m( 2, 3 ) = ( zNear + zFar ) / ( zNear - zFar );
+	}
+
+	return m;
+}
+
+// static
+inline Matrix4f Matrix4f::orthographicProjection( float left, float right, float bottom, float top, float zNear, float zFar, bool directX )
+{
+	Matrix4f m;
+
+	m( 0, 0 ) = 2.0f / ( right - left );
+	m( 1, 1 ) = 2.0f / ( top - bottom );
+	m( 3, 3 ) = 1.0f;
+
+	m( 0, 3 ) = ( left + right ) / ( left - right );
+	m( 1, 3 ) = ( top + bottom ) / ( bottom - top );
+
+	if( directX )
+	{
+		m( 2, 2 ) = 1.0f / ( zNear - zFar );
+		m( 2, 3 ) = zNear / ( zNear - zFar );
+	}
+	else
+	{
+		m( 2, 2 ) = 2.0f / ( zNear - zFar );
+		m( 2, 3 ) = ( zNear + zFar ) / ( zNear - zFar );
+	}
+
+	return m;
+}
+
+// static
+inline Matrix4f Matrix4f::perspectiveProjection( float fLeft, float fRight,
+										 float fBottom, float fTop,
+										 float fZNear, float fZFar,
+										 bool directX )
+{
+	Matrix4f projection; // zero matrix
+
+	projection( 0, 0 ) = ( 2.0f * fZNear ) / ( fRight - fLeft );
+	projection( 1, 1 ) = ( 2.0f * fZNear ) / ( fTop - fBottom );
+	projection( 0, 2 ) = ( fRight + fLeft ) / ( fRight - fLeft );
+	projection( 1, 2 ) = ( fTop + fBottom ) / ( fTop - fBottom );
+	projection( 3, 2 ) = -1;
+
+	if( directX )
+	{
+		projection( 2, 2 ) = fZFar / ( fZNear - fZFar);
+		projection( 2, 3 ) = ( fZNear * fZFar ) / ( fZNear - fZFar );
+	}
+	else
+	{
+		projection( 2, 2 ) = ( fZNear + fZFar ) / ( fZNear - fZFar );
+		projection( 2, 3 ) = ( 2.0f * fZNear * fZFar ) / ( fZNear - fZFar );
+	}
+
+	return projection;
+}
+
+// static
+inline Matrix4f Matrix4f::perspectiveProjection( float fovYRadians, float aspect, float zNear, float zFar, bool directX )
+{
+	Matrix4f m; // zero matrix
+
+	float yScale = 1.f / tanf( 0.5f * fovYRadians );
+	float xScale = yScale / aspect;
+
+	m( 0, 0 ) = xScale;
+	m( 1, 1 ) = yScale;
+	m( 3, 2 ) = -1;
+
+	if( directX )
+	{
+		m( 2, 2 ) = zFar / ( zNear - zFar );
+		m( 2, 3 ) = zNear * zFar / ( zNear - zFar );
+	}
+	else
+	{
+		m( 2, 2 ) = ( zFar + zNear ) / ( zNear - zFar );
+		m( 2, 3 ) = 2.f * zFar * zNear / ( zNear - zFar );
+	}
+
+	return m;
+}
+
+// static
+inline Matrix4f Matrix4f::infinitePerspectiveProjection( float fLeft, float fRight,
+												 float fBottom, float fTop,
+												 float fZNear, bool directX )
+{
+	Matrix4f projection;
+
+	projection( 0, 0 ) = ( 2.0f * fZNear ) / ( fRight - fLeft );
+	projection( 1, 1 ) = ( 2.0f * fZNear ) / ( fTop - fBottom );
+	projection( 0, 2 ) = ( fRight + fLeft ) / ( fRight - fLeft );
+	projection( 1, 2 ) = ( fTop + fBottom ) / ( fTop - fBottom );
+	projection( 3, 2 ) = -1;
+
+	// infinite view frustum
+	// just take the limit as far --> inf of the regular frustum
+	if( directX )
+	{
+		projection( 2, 2 ) = -1.0f;
+		projection( 2, 3 ) = -fZNear;		
+	}
+	else
+	{
+		projection( 2, 2 ) = -1.0f;
+		projection( 2, 3 ) = -2.0f * fZNear;
+	}
+
+	return projection;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Operators
+//////////////////////////////////////////////////////////////////////////
+
+inline Vector4f operator * ( const Matrix4f& m, const Vector4f& v )
+{
+	Vector4f output;
+	native4f::transform( m, v, output );
+	return output;
+}
+
+inline Matrix4f operator * ( const Matrix4f& x, const Matrix4f& y )
+{
+	Matrix4f product;
+	native4f::multiply( x, y, product );
+	return product;
+}
+
+// The kernels read Vector3f arrays as packed floats
+static_assert( sizeof( Vector3f ) == 3 * sizeof( float ), "Vector3f must be three packed floats" );
+
+inline void transformPoints( const Matrix4f& m, const Vector3f* points, Vector3f* out, size_t count )
+{
+	native4f::transformPoints( m, reinterpret_cast< const float* >( points ), reinterpret_cast< float* >( out ), count );
+}
+
+inline void transformVectors( const Matrix4f& m, const Vector3f* vectors, Vector3f* out, size_t count )
+{
+	native4f::transformVectors( m, reinterpret_cast< const float* >( vectors ), reinterpret_cast< float* >( out ), count );
+}
+
+inline void transformVectors( const Matrix3f& m, const Vector3f* vectors, Vector3f* out, size_t count )
+{
+	Matrix4f m4;
+	m4.setSubmatrix3x3( 0, 0, m );
+	transformVectors( m4, vectors, out, count );
+}
+
+inline void transformNormals( const Matrix4f& m, const Vector3f* normals, Vector3f* out, size_t count )
+{
+	transformVectors( m.getSubmatrix3x3( 0, 0 ).inverse().transposed(), normals, out, count );
+}
+
+inline void transformPointsSoA( const Matrix4f& m, const float* x, const float* y, const float* z,
+	float* outX, float* outY, float* outZ, size_t count )
+{
+	native4f::transformPointsSoA( m, x, y, z, outX, outY, outZ, count );
+}
+
+#endif // MATRIX4F_H
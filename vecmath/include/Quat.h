@@ -0,0 +1,173 @@
+#ifndef QUAT_H
+#define QUAT_H
+
+class Quat4f;
+template< typename T > class Vector3;
+
+// A quaternion q = w + x * i + y * j + z * k with components of type T,
+// the counterpart of Vector3< T > for rotations.  Quat4f stays the
+// quaternion used everywhere.
+template< typename T >
+class Quat
+{
+public:
+
+	constexpr Quat();
+	constexpr Quat( T w, T x, T y, T z );
+
+	// widening or narrowing from another precision
+	template< typename U >
+	constexpr explicit Quat( const Quat< U >& q );
+
+	explicit Quat( const Quat4f& q );
+	explicit operator Quat4f() const;
+
+	// returns the ith element, w first
+	constexpr const T& operator [] ( int i ) const;
+	constexpr T& operator [] ( int i );
+
+	constexpr T w() const;
+	constexpr T x() const;
+	constexpr T y() const;
+	constexpr T z() const;
+
+	T abs() const;
+	constexpr T absSquared() const;
+	Quat normalized() const;
+	constexpr Quat conjugated() const;
+
+	// the rotation of radians about axis, which need not be unit length
+	static Quat axisAngle( T radians, const Vector3< T >& axis );
+
+private:
+
+	T m_elements[ 4 ];
+
+};
+
+typedef Quat< double > Quat4d;
+
+// quaternion product
+template< typename T >
+constexpr Quat< T > operator * ( const Quat< T >& q0, const Quat< T >& q1 );
+
+#include <cmath>
+
+#include "Quat4f.h"
+#include "Vector3.h"
+
+template< typename T >
+constexpr Quat< T >::Quat()
+	: m_elements{}
+{
+}
+
+template< typename T >
+constexpr Quat< T >::Quat( T w, T x, T y, T z )
+	: m_elements{ w, x, y, z }
+{
+}
+
+template< typename T >
+template< typename U >
+constexpr Quat< T >::Quat( const Quat< U >& q )
+	: m_elements{ static_cast< T >( q[0] ), static_cast< T >( q[1] ), static_cast< T >( q[2] ), static_cast< T >( q[3] ) }
+{
+}
+
+template< typename T >
+inline Quat< T >::Quat( const Quat4f& q )
+	: m_elements{ static_cast< T >( q[0] ), static_cast< T >( q[1] ), static_cast< T >( q[2] ), static_cast< T >( q[3] ) }
+{
+}
+
+template< typename T >
+inline Quat< T >::operator Quat4f() const
+{
+	return Quat4f( static_cast< float >( m_elements[0] ), static_cast< float >( m_elements[1] ),
+		static_cast< float >( m_elements[2] ), static_cast< float >( m_elements[3] ) );
+}
+
+template< typename T >
+constexpr const T& Quat< T >::operator [] ( int i ) const
+{
+	return m_elements[i];
+}
+
+template< typename T >
+constexpr T& Quat< T >::operator [] ( int i )
+{
+	return m_elements[i];
+}
+
+template< typename T >
+constexpr T Quat< T >::w() const
+{
+	return m_elements[0];
+}
+
+template< typename T >
+constexpr T Quat< T >::x() const
+{
+	return m_elements[1];
+}
+
+template< typename T >
+constexpr T Quat< T >::y() const
+{
+	return m_elements[2];
+}
+
+template< typename T >
+constexpr T Quat< T >::z() const
+{
+	return m_elements[3];
+}
+
+template< typename T >
+inline T Quat< T >::abs() const
+{
+	return std::sqrt( absSquared() );
+}
+
+template< typename T >
+constexpr T Quat< T >::absSquared() const
+{
+	return m_elements[0] * m_elements[0] + m_elements[1] * m_elements[1] +
+		m_elements[2] * m_elements[2] + m_elements[3] * m_elements[3];
+}
+
+template< typename T >
+inline Quat< T > Quat< T >::normalized() const
+{
+	T norm = abs();
+	return Quat( m_elements[0] / norm, m_elements[1] / norm, m_elements[2] / norm, m_elements[3] / norm );
+}
+
+template< typename T >
+constexpr Quat< T > Quat< T >::conjugated() const
+{
+	return Quat( m_elements[0], -m_elements[1], -m_elements[2], -m_elements[3] );
+}
+
+// static
+template< typename T >
+inline Quat< T > Quat< T >::axisAngle( T radians, const Vector3< T >& axis )
+{
+	Vector3< T > v = std::sin( T( 0.5 ) * radians ) * axis.normalized();
+	return Quat( std::cos( T( 0.5 ) * radians ), v[0], v[1], v[2] );
+}
+
+template< typename T >
+constexpr Quat< T > operator * ( const Quat< T >& q0, const Quat< T >& q1 )
+{
+	return Quat< T >
+		(
+			q0.w() * q1.w() - q0.x() * q1.x() - q0.y() * q1.y() - q0.z() * q1.z(),
+			q0.w() * q1.x() + q0.x() * q1.w() + q0.y() * q1.z() - q0.z() * q1.y(),
+			q0.w() * q1.y() - q0.x() * q1.z() + q0.y() * q1.w() + q0.z() * q1.x(),
+			q0.w() * q1.z() + q0.x() * q1.y() - q0.y() * q1.x() + q0.z() * q1.w()
+		);
+}
+
+#endif // QUAT_H
@@ -0,0 +1,644 @@
+#ifndef SIMD_4F_H
+#define SIMD_4F_H
+
+// Kernels behind the 4-wide types: Matrix4f products and inverse and
+// the Quat4f product.  They work on the raw elements, matrices in
+// column major order and quaternions as ( w, x, y, z ), and the
+// operands and results must be 16-byte aligned, as the elements of
+// Vector4f, Quat4f and Matrix4f are.  Results may not alias operands.
+//
+// The batch transforms take arrays of count packed ( x, y, z ) points,
+// or three arrays of coordinates for the SoA version, which need no
+// alignment and may be transformed in place.
+//
+// scalar4f is plain C++.  simd4f uses SSE on x86 and NEON on ARM and
+// is only there when one of them is available; define VECMATH_NO_SIMD
+// to build without it.  native4f is the one the classes use.
+
+#if !defined( VECMATH_NO_SIMD ) && ( defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) )
+#define VECMATH_SSE 1
+#include <xmmintrin.h>
+#elif !defined( VECMATH_NO_SIMD ) && ( defined( __ARM_NEON ) || defined( _M_ARM64 ) )
+#define VECMATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined( VECMATH_SSE ) || defined( VECMATH_NEON )
+#define VECMATH_SIMD 1
+#endif
+
+#include <cstddef>
+
+namespace scalar4f
+{
+	// As Matrix3f::determinant3x3, which can't be included from here
+	// since Matrix3f.h pulls in Quat4f.h and with it this header.
+	inline float determinant3x3( float m00, float m01, float m02,
+		float m10, float m11, float m12,
+		float m20, float m21, float m22 )
+	{
+		return m00 * ( m11 * m22 - m12 * m21 ) - m01 * ( m10 * m22 - m12 * m20 ) + m02 * ( m10 * m21 - m11 * m20 );
+	}
+
+	// out = a * b
+	inline void multiply( const float* a, const float* b, float* out )
+	{
+		for( int j = 0; j < 4; ++j )
+		{
+			const float* bj = b + 4 * j;
+			for( int i = 0; i < 4; ++i )
+			{
+				out[ 4 * j + i ] = a[ i ] * bj[ 0 ] + a[ 4 + i ] * bj[ 1 ] + a[ 8 + i ] * bj[ 2 ] + a[ 12 + i ] * bj[ 3 ];
+			}
+		}
+	}
+
+	// out = m * v
+	inline void transform( const float* m, const float* v, float* out )
+	{
+		for( int i = 0; i < 4; ++i )
+		{
+			out[ i ] = m[ i ] * v[ 0 ] + m[ 4 + i ] * v[ 1 ] + m[ 8 + i ] * v[ 2 ] + m[ 12 + i ] * v[ 3 ];
+		}
+	}
+
+	// out = q0 * q1
+	inline void quatProduct( const float* q0, const float* q1, float* out )
+	{
+		out[ 0 ] = q0[ 0 ] * q1[ 0 ] - q0[ 1 ] * q1[ 1 ] - q0[ 2 ] * q1[ 2 ] - q0[ 3 ] * q1[ 3 ];
+		out[ 1 ] = q0[ 0 ] * q1[ 1 ] + q0[ 1 ] * q1[ 0 ] + q0[ 2 ] * q1[ 3 ] - q0[ 3 ] * q1[ 2 ];
+		out[ 2 ] = q0[ 0 ] * q1[ 2 ] - q0[ 1 ] * q1[ 3 ] + q0[ 2 ] * q1[ 0 ] + q0[ 3 ] * q1[ 1 ];
+		out[ 3 ] = q0[ 0 ] * q1[ 3 ] + q0[ 1 ] * q1[ 2 ] - q0[ 2 ] * q1[ 1 ] + q0[ 3 ] * q1[ 0 ];
+	}
+
+	// out = m^-1, by cofactors.  Returns the determinant of m; out is
+	// not finite if it's 0.
+	inline float inverse( const float* m, float* out )
+	{
+		float m00 = m[ 0 ];
+		float m10 = m[ 1 ];
+		float m20 = m[ 2 ];
+		float m30 = m[ 3 ];
+
+		float m01 = m[ 4 ];
+		float m11 = m[ 5 ];
+		float m21 = m[ 6 ];
+		float m31 = m[ 7 ];
+
+		float m02 = m[ 8 ];
+		float m12 = m[ 9 ];
+		float m22 = m[ 10 ];
+		float m32 = m[ 11 ];
+
+		float m03 = m[ 12 ];
+		float m13 = m[ 13 ];
+		float m23 = m[ 14 ];
+		float m33 = m[ 15 ];
+
+		float cofactor00 =  determinant3x3( m11, m12, m13, m21, m22, m23, m31, m32, m33 );
+		float cofactor01 = -determinant3x3( m12, m13, m10, m22, m23, m20, m32, m33, m30 );
+		float cofactor02 =  determinant3x3( m13, m10, m11, m23, m20, m21, m33, m30, m31 );
+		float cofactor03 = -determinant3x3( m10, m11, m12, m20, m21, m22, m30, m31, m32 );
+
+		float cofactor10 = -determinant3x3( m21, m22, m23, m31, m32, m33, m01, m02, m03 );
+		float cofactor11 =  determinant3x3( m22, m23, m20, m32, m33, m30, m02, m03, m00 );
+		float cofactor12 = -determinant3x3( m23, m20, m21, m33, m30, m31, m03, m00, m01 );
+		float cofactor13 =  determinant3x3( m20, m21, m22, m30, m31, m32, m00, m01, m02 );
+
+		float cofactor20 =  determinant3x3( m31, m32, m33, m01, m02, m03, m11, m12, m13 );
+		float cofactor21 = -determinant3x3( m32, m33, m30, m02, m03, m00, m12, m13, m10 );
+		float cofactor22 =  determinant3x3( m33, m30, m31, m03, m00, m01, m13, m10, m11 );
+		float cofactor23 = -determinant3x3( m30, m31, m32, m00, m01, m02, m10, m11, m12 );
+
+		float cofactor30 = -determinant3x3( m01, m02, m03, m11, m12, m13, m21, m22, m23 );
+		float cofactor31 =  determinant3x3( m02, m03, m00, m12, m13, m10, m22, m23, m20 );
+		float cofactor32 = -determinant3x3( m03, m00, m01, m13, m10, m11, m23, m20, m21 );
+		float cofactor33 =  determinant3x3( m00, m01, m02, m10, m11, m12, m20, m21, m22 );
+
+		float determinant = m00 * cofactor00 + m01 * cofactor01 + m02 * cofactor02 + m03 * cofactor03;
+		float r = 1.0f / determinant;
+
+		// the inverse is the transposed cofactor matrix over the
+		// determinant, so row i of the cofactors is column i of out
+		out[ 0 ] = cofactor00 * r; out[ 1 ] = cofactor01 * r; out[ 2 ] = cofactor02 * r; out[ 3 ] = cofactor03 * r;
+		out[ 4 ] = cofactor10 * r; out[ 5 ] = cofactor11 * r; out[ 6 ] = cofactor12 * r; out[ 7 ] = cofactor13 * r;
+		out[ 8 ] = cofactor20 * r; out[ 9 ] = cofactor21 * r; out[ 10 ] = cofactor22 * r; out[ 11 ] = cofactor23 * r;
+		out[ 12 ] = cofactor30 * r; out[ 13 ] = cofactor31 * r; out[ 14 ] = cofactor32 * r; out[ 15 ] = cofactor33 * r;
+
+		return determinant;
+	}
+	// out[ i ] = m * ( p[ i ], 1 )
+	inline void transformPoints( const float* m, const float* p, float* out, size_t count )
+	{
+		const float m00 = m[ 0 ], m01 = m[ 4 ], m02 = m[ 8 ], m03 = m[ 12 ];
+		const float m10 = m[ 1 ], m11 = m[ 5 ], m12 = m[ 9 ], m13 = m[ 13 ];
+		const float m20 = m[ 2 ], m21 = m[ 6 ], m22 = m[ 10 ], m23 = m[ 14 ];
+
+		for( size_t i = 0; i < 3 * count; i += 3 )
+		{
+			float x = p[ i ], y = p[ i + 1 ], z = p[ i + 2 ];
+			out[ i ] = m00 * x + m01 * y + m02 * z + m03;
+			out[ i + 1 ] = m10 * x + m11 * y + m12 * z + m13;
+			out[ i + 2 ] = m20 * x + m21 * y + m22 * z + m23;
+		}
+	}
+
+	// out[ i ] = m * ( v[ i ], 0 )
+	inline void transformVectors( const float* m, const float* v, float* out, size_t count )
+	{
+		const float m00 = m[ 0 ], m01 = m[ 4 ], m02 = m[ 8 ];
+		const float m10 = m[ 1 ], m11 = m[ 5 ], m12 = m[ 9 ];
+		const float m20 = m[ 2 ], m21 = m[ 6 ], m22 = m[ 10 ];
+
+		for( size_t i = 0; i < 3 * count; i += 3 )
+		{
+			float x = v[ i ], y = v[ i + 1 ], z = v[ i + 2 ];
+			out[ i ] = m00 * x + m01 * y + m02 * z;
+			out[ i + 1 ] = m10 * x + m11 * y + m12 * z;
+			out[ i + 2 ] = m20 * x + m21 * y + m22 * z;
+		}
+	}
+
+	// transformPoints on separate x, y and z arrays
+	inline void transformPointsSoA( const float* m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count )
+	{
+		const float m00 = m[ 0 ], m01 = m[ 4 ], m02 = m[ 8 ], m03 = m[ 12 ];
+		const float m10 = m[ 1 ], m11 = m[ 5 ], m12 = m[ 9 ], m13 = m[ 13 ];
+		const float m20 = m[ 2 ], m21 = m[ 6 ], m22 = m[ 10 ], m23 = m[ 14 ];
+
+		for( size_t i = 0; i < count; ++i )
+		{
+			float px = x[ i ], py = y[ i ], pz = z[ i ];
+			outX[ i ] = m00 * px + m01 * py + m02 * pz + m03;
+			outY[ i ] = m10 * px + m11 * py + m12 * pz + m13;
+			outZ[ i ] = m20 * px + m21 * py + m22 * pz + m23;
+		}
+	}
+}
+
+#if defined( VECMATH_SSE )
+
+namespace simd4f
+{
+	// _mm_shuffle_ps with the lanes in reading order
+	#define VECMATH_SHUFFLE( a, b, x, y, z, w ) _mm_shuffle_ps( a, b, _MM_SHUFFLE( w, z, y, x ) )
+	#define VECMATH_SWIZZLE( a, x, y, z, w ) VECMATH_SHUFFLE( a, a, x, y, z, w )
+
+	inline __m128 transformColumns( __m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v )
+	{
+		__m128 out = _mm_mul_ps( c0, VECMATH_SWIZZLE( v, 0, 0, 0, 0 ) );
+		out = _mm_add_ps( out, _mm_mul_ps( c1, VECMATH_SWIZZLE( v, 1, 1, 1, 1 ) ) );
+		out = _mm_add_ps( out, _mm_mul_ps( c2, VECMATH_SWIZZLE( v, 2, 2, 2, 2 ) ) );
+		return _mm_add_ps( out, _mm_mul_ps( c3, VECMATH_SWIZZLE( v, 3, 3, 3, 3 ) ) );
+	}
+
+	inline void multiply( const float* a, const float* b, float* out )
+	{
+		__m128 c0 = _mm_load_ps( a );
+		__m128 c1 = _mm_load_ps( a + 4 );
+		__m128 c2 = _mm_load_ps( a + 8 );
+		__m128 c3 = _mm_load_ps( a + 12 );
+
+		for( int j = 0; j < 16; j += 4 )
+		{
+			_mm_store_ps( out + j, transformColumns( c0, c1, c2, c3, _mm_load_ps( b + j ) ) );
+		}
+	}
+
+	inline void transform( const float* m, const float* v, float* out )
+	{
+		_mm_store_ps( out, transformColumns( _mm_load_ps( m ), _mm_load_ps( m + 4 ),
+			_mm_load_ps( m + 8 ), _mm_load_ps( m + 12 ), _mm_load_ps( v ) ) );
+	}
+
+	// The rows of scalar4f::quatProduct, regrouped by element of q0:
+	// q0 * q1 = w0 * q1 + x0 * ( -x1, w1, -z1, y1 )
+	//         + y0 * ( -y1, z1, w1, -x1 ) + z0 * ( -z1, -y1, x1, w1 )
+	inline void quatProduct( const float* q0, const float* q1, float* out )
+	{
+		__m128 a = _mm_load_ps( q0 );
+		__m128 b = _mm_load_ps( q1 );
+
+		__m128 out0 = _mm_mul_ps( VECMATH_SWIZZLE( a, 0, 0, 0, 0 ), b );
+		__m128 x = _mm_mul_ps( VECMATH_SWIZZLE( a, 1, 1, 1, 1 ), VECMATH_SWIZZLE( b, 1, 0, 3, 2 ) );
+		__m128 y = _mm_mul_ps( VECMATH_SWIZZLE( a, 2, 2, 2, 2 ), VECMATH_SWIZZLE( b, 2, 3, 0, 1 ) );
+		__m128 z = _mm_mul_ps( VECMATH_SWIZZLE( a, 3, 3, 3, 3 ), VECMATH_SWIZZLE( b, 3, 2, 1, 0 ) );
+
+		x = _mm_mul_ps( x, _mm_setr_ps( -1, 1, -1, 1 ) );
+		y = _mm_mul_ps( y, _mm_setr_ps( -1, 1, 1, -1 ) );
+		z = _mm_mul_ps( z, _mm_setr_ps( -1, -1, 1, 1 ) );
+
+		_mm_store_ps( out, _mm_add_ps( _mm_add_ps( out0, x ), _mm_add_ps( y, z ) ) );
+	}
+
+	// 2x2 matrices are kept in one register as ( m00, m01, m10, m11 )
+
+	// a * b
+	inline __m128 multiply2x2( __m128 a, __m128 b )
+	{
+		return _mm_add_ps( _mm_mul_ps( a, VECMATH_SWIZZLE( b, 0, 3, 0, 3 ) ),
+			_mm_mul_ps( VECMATH_SWIZZLE( a, 1, 0, 3, 2 ), VECMATH_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+	}
+
+	// adjugate( a ) * b
+	inline __m128 adjugateMultiply2x2( __m128 a, __m128 b )
+	{
+		return _mm_sub_ps( _mm_mul_ps( VECMATH_SWIZZLE( a, 3, 3, 0, 0 ), b ),
+			_mm_mul_ps( VECMATH_SWIZZLE( a, 1, 1, 2, 2 ), VECMATH_SWIZZLE( b, 2, 3, 0, 1 ) ) );
+	}
+
+	// a * adjugate( b )
+	inline __m128 multiplyAdjugate2x2( __m128 a, __m128 b )
+	{
+		return _mm_sub_ps( _mm_mul_ps( a, VECMATH_SWIZZLE( b, 3, 0, 3, 0 ) ),
+			_mm_mul_ps( VECMATH_SWIZZLE( a, 1, 0, 3, 2 ), VECMATH_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+	}
+
+	// Blockwise inversion of m = [ A B ; C D ] with 2x2 blocks, which
+	// needs only the 2x2 adjugates and determinants.  It is written
+	// for rows, and run on the columns it inverts the transpose, whose
+	// inverse stored by columns is the inverse of m.
+	inline float inverse( const float* m, float* out )
+	{
+		__m128 r0 = _mm_load_ps( m );
+		__m128 r1 = _mm_load_ps( m + 4 );
+		__m128 r2 = _mm_load_ps( m + 8 );
+		__m128 r3 = _mm_load_ps( m + 12 );
+
+		__m128 A = _mm_movelh_ps( r0, r1 );
+		__m128 B = _mm_movehl_ps( r1, r0 );
+		__m128 C = _mm_movelh_ps( r2, r3 );
+		__m128 D = _mm_movehl_ps( r3, r2 );
+
+		// ( |A|, |B|, |C|, |D| )
+		__m128 subDeterminants = _mm_sub_ps(
+			_mm_mul_ps( VECMATH_SHUFFLE( r0, r2, 0, 2, 0, 2 ), VECMATH_SHUFFLE( r1, r3, 1, 3, 1, 3 ) ),
+			_mm_mul_ps( VECMATH_SHUFFLE( r0, r2, 1, 3, 1, 3 ), VECMATH_SHUFFLE( r1, r3, 0, 2, 0, 2 ) ) );
+		__m128 detA = VECMATH_SWIZZLE( subDeterminants, 0, 0, 0, 0 );
+		__m128 detB = VECMATH_SWIZZLE( subDeterminants, 1, 1, 1, 1 );
+		__m128 detC = VECMATH_SWIZZLE( subDeterminants, 2, 2, 2, 2 );
+		__m128 detD = VECMATH_SWIZZLE( subDeterminants, 3, 3, 3, 3 );
+
+		__m128 adjDC = adjugateMultiply2x2( D, C );
+		__m128 adjAB = adjugateMultiply2x2( A, B );
+
+		// m^-1 = 1 / |m| * [ X Y ; Z W ], with the adjugates of the blocks
+		__m128 X = _mm_sub_ps( _mm_mul_ps( detD, A ), multiply2x2( B, adjDC ) );
+		__m128 W = _mm_sub_ps( _mm_mul_ps( detA, D ), multiply2x2( C, adjAB ) );
+		__m128 Y = _mm_sub_ps( _mm_mul_ps( detB, C ), multiplyAdjugate2x2( D, adjAB ) );
+		__m128 Z = _mm_sub_ps( _mm_mul_ps( detC, B ), multiplyAdjugate2x2( A, adjDC ) );
+
+		// |m| = |A| |D| + |B| |C| - tr( adj( A ) B adj( D ) C )
+		__m128 trace = _mm_mul_ps( adjAB, VECMATH_SWIZZLE( adjDC, 0, 2, 1, 3 ) );
+		trace = _mm_add_ps( trace, _mm_movehl_ps( trace, trace ) );
+		trace = _mm_add_ss( trace, VECMATH_SWIZZLE( trace, 1, 1, 1, 1 ) );
+		__m128 determinant = _mm_sub_ss( _mm_add_ss( _mm_mul_ss( detA, detD ), _mm_mul_ss( detB, detC ) ), trace );
+		determinant = VECMATH_SWIZZLE( determinant, 0, 0, 0, 0 );
+
+		// the signs turn the blocks into their adjugates
+		__m128 r = _mm_div_ps( _mm_setr_ps( 1, -1, -1, 1 ), determinant );
+		X = _mm_mul_ps( X, r );
+		Y = _mm_mul_ps( Y, r );
+		Z = _mm_mul_ps( Z, r );
+		W = _mm_mul_ps( W, r );
+
+		_mm_store_ps( out, VECMATH_SHUFFLE( X, Y, 3, 1, 3, 1 ) );
+		_mm_store_ps( out + 4, VECMATH_SHUFFLE( X, Y, 2, 0, 2, 0 ) );
+		_mm_store_ps( out + 8, VECMATH_SHUFFLE( Z, W, 3, 1, 3, 1 ) );
+		_mm_store_ps( out + 12, VECMATH_SHUFFLE( Z, W, 2, 0, 2, 0 ) );
+
+		return _mm_cvtss_f32( determinant );
+	}
+
+	// The rows of m times ( x, y, z ) for four points at once, summed
+	// in the same order as in scalar4f, with w = 1 for points and 0
+	// for vectors.
+	inline void transformColumns4( const float* m, bool points, __m128& x, __m128& y, __m128& z )
+	{
+		__m128 outX = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( m[ 0 ] ), x ), _mm_mul_ps( _mm_set1_ps( m[ 4 ] ), y ) ), _mm_mul_ps( _mm_set1_ps( m[ 8 ] ), z ) );
+		__m128 outY = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( m[ 1 ] ), x ), _mm_mul_ps( _mm_set1_ps( m[ 5 ] ), y ) ), _mm_mul_ps( _mm_set1_ps( m[ 9 ] ), z ) );
+		__m128 outZ = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( m[ 2 ] ), x ), _mm_mul_ps( _mm_set1_ps( m[ 6 ] ), y ) ), _mm_mul_ps( _mm_set1_ps( m[ 10 ] ), z ) );
+
+		if( points )
+		{
+			outX = _mm_add_ps( outX, _mm_set1_ps( m[ 12 ] ) );
+			outY = _mm_add_ps( outY, _mm_set1_ps( m[ 13 ] ) );
+			outZ = _mm_add_ps( outZ, _mm_set1_ps( m[ 14 ] ) );
+		}
+
+		x = outX;
+		y = outY;
+		z = outZ;
+	}
+
+	// Four packed points are three registers, ( x0 y0 z0 x1 ),
+	// ( y1 z1 x2 y2 ) and ( z2 x3 y3 z3 ), which are shuffled into x,
+	// y and z registers, transformed and shuffled back.
+	inline void transformPacked( const float* m, bool points, const float* p, float* out, size_t count )
+	{
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 )
+		{
+			__m128 a = _mm_loadu_ps( p + 3 * i );
+			__m128 b = _mm_loadu_ps( p + 3 * i + 4 );
+			__m128 c = _mm_loadu_ps( p + 3 * i + 8 );
+
+			__m128 yz01 = VECMATH_SHUFFLE( a, b, 1, 2, 0, 1 );
+			__m128 xy23 = VECMATH_SHUFFLE( b, c, 2, 3, 1, 2 );
+			__m128 x = VECMATH_SHUFFLE( a, xy23, 0, 3, 0, 2 );
+			__m128 y = VECMATH_SHUFFLE( yz01, xy23, 0, 2, 1, 3 );
+			__m128 z = VECMATH_SHUFFLE( yz01, c, 1, 3, 0, 3 );
+
+			transformColumns4( m, points, x, y, z );
+
+			__m128 xy = VECMATH_SHUFFLE( x, y, 0, 1, 0, 1 );
+			__m128 zx = VECMATH_SHUFFLE( z, x, 0, 0, 1, 1 );
+			__m128 yz = VECMATH_SHUFFLE( y, z, 1, 1, 1, 1 );
+			__m128 xy2 = VECMATH_SHUFFLE( x, y, 2, 2, 2, 2 );
+			__m128 zx2 = VECMATH_SHUFFLE( z, x, 2, 2, 3, 3 );
+			__m128 yz3 = VECMATH_SHUFFLE( y, z, 3, 3, 3, 3 );
+
+			_mm_storeu_ps( out + 3 * i, VECMATH_SHUFFLE( xy, zx, 0, 2, 0, 2 ) );
+			_mm_storeu_ps( out + 3 * i + 4, VECMATH_SHUFFLE( yz, xy2, 0, 2, 0, 2 ) );
+			_mm_storeu_ps( out + 3 * i + 8, VECMATH_SHUFFLE( zx2, yz3, 0, 2, 0, 2 ) );
+		}
+
+		if( points )
+		{
+			scalar4f::transformPoints( m, p + 3 * i, out + 3 * i, count - i );
+		}
+		else
+		{
+			scalar4f::transformVectors( m, p + 3 * i, out + 3 * i, count - i );
+		}
+	}
+
+	inline void transformPoints( const float* m, const float* p, float* out, size_t count )
+	{
+		transformPacked( m, true, p, out, count );
+	}
+
+	inline void transformVectors( const float* m, const float* v, float* out, size_t count )
+	{
+		transformPacked( m, false, v, out, count );
+	}
+
+	inline void transformPointsSoA( const float* m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count )
+	{
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 )
+		{
+			__m128 px = _mm_loadu_ps( x + i );
+			__m128 py = _mm_loadu_ps( y + i );
+			__m128 pz = _mm_loadu_ps( z + i );
+
+			transformColumns4( m, true, px, py, pz );
+
+			_mm_storeu_ps( outX + i, px );
+			_mm_storeu_ps( outY + i, py );
+			_mm_storeu_ps( outZ + i, pz );
+		}
+
+		scalar4f::transformPointsSoA( m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i );
+	}
+
+	#undef VECMATH_SWIZZLE
+	#undef VECMATH_SHUFFLE
+}
+
+#elif defined( VECMATH_NEON )
+
+namespace simd4f
+{
+	inline float32x4_t transformColumns( float32x4_t c0, float32x4_t c1, float32x4_t c2, float32x4_t c3, float32x4_t v )
+	{
+		float32x4_t out = vmulq_n_f32( c0, vgetq_lane_f32( v, 0 ) );
+		out = vmlaq_n_f32( out, c1, vgetq_lane_f32( v, 1 ) );
+		out = vmlaq_n_f32( out, c2, vgetq_lane_f32( v, 2 ) );
+		return vmlaq_n_f32( out, c3, vgetq_lane_f32( v, 3 ) );
+	}
+
+	inline void multiply( const float* a, const float* b, float* out )
+	{
+		float32x4_t c0 = vld1q_f32( a );
+		float32x4_t c1 = vld1q_f32( a + 4 );
+		float32x4_t c2 = vld1q_f32( a + 8 );
+		float32x4_t c3 = vld1q_f32( a + 12 );
+
+		for( int j = 0; j < 16; j += 4 )
+		{
+			vst1q_f32( out + j, transformColumns( c0, c1, c2, c3, vld1q_f32( b + j ) ) );
+		}
+	}
+
+	inline void transform( const float* m, const float* v, float* out )
+	{
+		vst1q_f32( out, transformColumns( vld1q_f32( m ), vld1q_f32( m + 4 ),
+			vld1q_f32( m + 8 ), vld1q_f32( m + 12 ), vld1q_f32( v ) ) );
+	}
+
+	// As the SSE version: q0 * q1 = w0 * q1 + x0 * ( -x1, w1, -z1, y1 )
+	// + y0 * ( -y1, z1, w1, -x1 ) + z0 * ( -z1, -y1, x1, w1 )
+	inline void quatProduct( const float* q0, const float* q1, float* out )
+	{
+		static const float xSigns[ 4 ] = { -1, 1, -1, 1 };
+		static const float ySigns[ 4 ] = { -1, 1, 1, -1 };
+		static const float zSigns[ 4 ] = { -1, -1, 1, 1 };
+
+		float32x4_t b = vld1q_f32( q1 );
+		float32x4_t b1032 = vrev64q_f32( b );
+		float32x4_t b2301 = vcombine_f32( vget_high_f32( b ), vget_low_f32( b ) );
+		float32x4_t b3210 = vrev64q_f32( b2301 );
+
+		float32x4_t out0 = vmulq_n_f32( b, q0[ 0 ] );
+		out0 = vmlaq_n_f32( out0, vmulq_f32( b1032, vld1q_f32( xSigns ) ), q0[ 1 ] );
+		out0 = vmlaq_n_f32( out0, vmulq_f32( b2301, vld1q_f32( ySigns ) ), q0[ 2 ] );
+		out0 = vmlaq_n_f32( out0, vmulq_f32( b3210, vld1q_f32( zSigns ) ), q0[ 3 ] );
+
+		vst1q_f32( out, out0 );
+	}
+
+	// 2x2 matrices are kept in one register as ( m00, m01, m10, m11 ),
+	// as in the SSE version.  NEON has no general shuffle, so the
+	// swizzles are built from lane reversals, transposes and
+	// duplicates.
+
+	// ( ( m00, m11 ), ( m01, m10 ) )
+	inline float32x2x2_t diagonals2x2( float32x4_t m )
+	{
+		return vtrn_f32( vget_low_f32( m ), vrev64_f32( vget_high_f32( m ) ) );
+	}
+
+	// a * b
+	inline float32x4_t multiply2x2( float32x4_t a, float32x4_t b )
+	{
+		float32x2x2_t d = diagonals2x2( b );
+		float32x2_t b21 = vrev64_f32( d.val[ 1 ] );
+		return vaddq_f32( vmulq_f32( a, vcombine_f32( d.val[ 0 ], d.val[ 0 ] ) ),
+			vmulq_f32( vrev64q_f32( a ), vcombine_f32( b21, b21 ) ) );
+	}
+
+	// adjugate( a ) * b
+	inline float32x4_t adjugateMultiply2x2( float32x4_t a, float32x4_t b )
+	{
+		float32x2_t aLow = vget_low_f32( a );
+		float32x2_t aHigh = vget_high_f32( a );
+		float32x4_t a3300 = vcombine_f32( vdup_lane_f32( aHigh, 1 ), vdup_lane_f32( aLow, 0 ) );
+		float32x4_t a1122 = vcombine_f32( vdup_lane_f32( aLow, 1 ), vdup_lane_f32( aHigh, 0 ) );
+		float32x4_t b2301 = vcombine_f32( vget_high_f32( b ), vget_low_f32( b ) );
+		return vsubq_f32( vmulq_f32( a3300, b ), vmulq_f32( a1122, b2301 ) );
+	}
+
+	// a * adjugate( b )
+	inline float32x4_t multiplyAdjugate2x2( float32x4_t a, float32x4_t b )
+	{
+		float32x2x2_t d = diagonals2x2( b );
+		float32x2_t b30 = vrev64_f32( d.val[ 0 ] );
+		float32x2_t b21 = vrev64_f32( d.val[ 1 ] );
+		return vsubq_f32( vmulq_f32( a, vcombine_f32( b30, b30 ) ),
+			vmulq_f32( vrev64q_f32( a ), vcombine_f32( b21, b21 ) ) );
+	}
+
+	// The blockwise inversion of the SSE version, with the same
+	// operations in the same order, so both give the same bits.
+	inline float inverse( const float* m, float* out )
+	{
+		float32x4_t r0 = vld1q_f32( m );
+		float32x4_t r1 = vld1q_f32( m + 4 );
+		float32x4_t r2 = vld1q_f32( m + 8 );
+		float32x4_t r3 = vld1q_f32( m + 12 );
+
+		float32x4_t A = vcombine_f32( vget_low_f32( r0 ), vget_low_f32( r1 ) );
+		float32x4_t B = vcombine_f32( vget_high_f32( r0 ), vget_high_f32( r1 ) );
+		float32x4_t C = vcombine_f32( vget_low_f32( r2 ), vget_low_f32( r3 ) );
+		float32x4_t D = vcombine_f32( vget_high_f32( r2 ), vget_high_f32( r3 ) );
+
+		// ( |A|, |B|, |C|, |D| )
+		float32x4x2_t r02 = vuzpq_f32( r0, r2 );
+		float32x4x2_t r13 = vuzpq_f32( r1, r3 );
+		float32x4_t subDeterminants = vsubq_f32( vmulq_f32( r02.val[ 0 ], r13.val[ 1 ] ),
+			vmulq_f32( r02.val[ 1 ], r13.val[ 0 ] ) );
+		float detA = vgetq_lane_f32( subDeterminants, 0 );
+		float detB = vgetq_lane_f32( subDeterminants, 1 );
+		float detC = vgetq_lane_f32( subDeterminants, 2 );
+		float detD = vgetq_lane_f32( subDeterminants, 3 );
+
+		float32x4_t adjDC = adjugateMultiply2x2( D, C );
+		float32x4_t adjAB = adjugateMultiply2x2( A, B );
+
+		// m^-1 = 1 / |m| * [ X Y ; Z W ], with the adjugates of the blocks
+		float32x4_t X = vsubq_f32( vmulq_n_f32( A, detD ), multiply2x2( B, adjDC ) );
+		float32x4_t W = vsubq_f32( vmulq_n_f32( D, detA ), multiply2x2( C, adjAB ) );
+		float32x4_t Y = vsubq_f32( vmulq_n_f32( C, detB ), multiplyAdjugate2x2( D, adjAB ) );
+		float32x4_t Z = vsubq_f32( vmulq_n_f32( B, detC ), multiplyAdjugate2x2( A, adjDC ) );
+
+		// |m| = |A| |D| + |B| |C| - tr( adj( A ) B adj( D ) C )
+		float32x2x2_t dc = vtrn_f32( vget_low_f32( adjDC ), vget_high_f32( adjDC ) );
+		float32x4_t trace = vmulq_f32( adjAB, vcombine_f32( dc.val[ 0 ], dc.val[ 1 ] ) );
+		float32x2_t traceHalves = vadd_f32( vget_low_f32( trace ), vget_high_f32( trace ) );
+		float determinant = ( detA * detD + detB * detC ) - vget_lane_f32( vpadd_f32( traceHalves, traceHalves ), 0 );
+
+		// the signs turn the blocks into their adjugates
+		static const float signs[ 4 ] = { 1, -1, -1, 1 };
+		float32x4_t r = vmulq_n_f32( vld1q_f32( signs ), 1.0f / determinant );
+		X = vmulq_f32( X, r );
+		Y = vmulq_f32( Y, r );
+		Z = vmulq_f32( Z, r );
+		W = vmulq_f32( W, r );
+
+		// ( X3, X1, Y3, Y1 ) and ( X2, X0, Y2, Y0 ), and the same for Z, W
+		float32x4x2_t XY = vuzpq_f32( X, Y );
+		float32x4x2_t ZW = vuzpq_f32( Z, W );
+		vst1q_f32( out, vrev64q_f32( XY.val[ 1 ] ) );
+		vst1q_f32( out + 4, vrev64q_f32( XY.val[ 0 ] ) );
+		vst1q_f32( out + 8, vrev64q_f32( ZW.val[ 1 ] ) );
+		vst1q_f32( out + 12, vrev64q_f32( ZW.val[ 0 ] ) );
+
+		return determinant;
+	}
+
+	// vld3q_f32 splits four packed points into x, y and z registers,
+	// and vst3q_f32 packs them again.
+	inline void transformColumns4( const float* m, bool points, float32x4x3_t& p )
+	{
+		float32x4_t x = vmulq_n_f32( p.val[ 0 ], m[ 0 ] );
+		float32x4_t y = vmulq_n_f32( p.val[ 0 ], m[ 1 ] );
+		float32x4_t z = vmulq_n_f32( p.val[ 0 ], m[ 2 ] );
+		x = vaddq_f32( x, vmulq_n_f32( p.val[ 1 ], m[ 4 ] ) );
+		y = vaddq_f32( y, vmulq_n_f32( p.val[ 1 ], m[ 5 ] ) );
+		z = vaddq_f32( z, vmulq_n_f32( p.val[ 1 ], m[ 6 ] ) );
+		x = vaddq_f32( x, vmulq_n_f32( p.val[ 2 ], m[ 8 ] ) );
+		y = vaddq_f32( y, vmulq_n_f32( p.val[ 2 ], m[ 9 ] ) );
+		z = vaddq_f32( z, vmulq_n_f32( p.val[ 2 ], m[ 10 ] ) );
+
+		if( points )
+		{
+			x = vaddq_f32( x, vdupq_n_f32( m[ 12 ] ) );
+			y = vaddq_f32( y, vdupq_n_f32( m[ 13 ] ) );
+			z = vaddq_f32( z, vdupq_n_f32( m[ 14 ] ) );
+		}
+
+		p.val[ 0 ] = x;
+		p.val[ 1 ] = y;
+		p.val[ 2 ] = z;
+	}
+
+	inline void transformPoints( const float* m, const float* p, float* out, size_t count )
+	{
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 )
+		{
+			float32x4x3_t xyz = vld3q_f32( p + 3 * i );
+			transformColumns4( m, true, xyz );
+			vst3q_f32( out + 3 * i, xyz );
+		}
+
+		scalar4f::transformPoints( m, p + 3 * i, out + 3 * i, count - i );
+	}
+
+	inline void transformVectors( const float* m, const float* v, float* out, size_t count )
+	{
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 )
+		{
+			float32x4x3_t xyz = vld3q_f32( v + 3 * i );
+			transformColumns4( m, false, xyz );
+			vst3q_f32( out + 3 * i, xyz );
+		}
+
+		scalar4f::transformVectors( m, v + 3 * i, out + 3 * i, count - i );
+	}
+
+	inline void transformPointsSoA( const float* m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count )
+	{
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 )
+		{
+			float32x4x3_t xyz;
+			xyz.val[ 0 ] = vld1q_f32( x + i );
+			xyz.val[ 1 ] = vld1q_f32( y + i );
+			xyz.val[ 2 ] = vld1q_f32( z + i );
+
+			transformColumns4( m, true, xyz );
+
+			vst1q_f32( outX + i, xyz.val[ 0 ] );
+			vst1q_f32( outY + i, xyz.val[ 1 ] );
+			vst1q_f32( outZ + i, xyz.val[ 2 ] );
+		}
+
+		scalar4f::transformPointsSoA( m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i );
+	}
+}
+
+#endif
+
+#if defined( VECMATH_SIMD )
+namespace native4f = simd4f;
+#else
+namespace native4f = scalar4f;
+#endif
+
+#endif // SIMD_4F_H
@@ -0,0 +1,319 @@
+#ifndef VECTOR_2F_H
+#define VECTOR_2F_H
+
+#include <cmath>
+
+class Vector3f;
+
+class Vector2f
+{
+public:
+    
+    static const Vector2f ZERO;
+	static const Vector2f UP;
+	static const Vector2f RIGHT;
+
+    constexpr Vector2f( float f = 0.f );
+    constexpr Vector2f( float x, float y );
+
+	// copy constructors
+    Vector2f( const Vector2f& rv ) = default;
+
+	// assignment operators
+	Vector2f& operator = ( const Vector2f& rv ) = default;
+
+	// no destructor necessary
+
+	// returns the ith element
+    constexpr const float& operator [] ( int i ) const;
+	constexpr float& operator [] ( int i );
+
+    constexpr float& x();
+	constexpr float& y();
+
+	constexpr float x() const;
+	constexpr float y() const;
+
+    constexpr Vector2f xy() const;
+	constexpr Vector2f yx() const;
+	constexpr Vector2f xx() const;
+	constexpr Vector2f yy() const;
+
+	// returns ( -y, x )
+    constexpr Vector2f normal() const;
+
+    float abs() const;
+    float absSquared() const;
+    void normalize();
+    Vector2f normalized() const;
+
+    void negate();
+
+	// ---- Utility ----
+    operator const float* () const; // automatic type conversion for OpenGL 
+    operator float* (); // automatic type conversion for OpenGL 
+	void print() const;
+
+	Vector2f& operator += ( const Vector2f& v );
+	Vector2f& operator -= ( const Vector2f& v );
+	Vector2f& operator *= ( float f );
+
+    static constexpr float dot( const Vector2f& v0, const Vector2f& v1 );
+
+	static constexpr Vector3f cross( const Vector2f& v0, const Vector2f& v1 );
+
+	// returns v0 * ( 1 - alpha ) * v1 * alpha
+	static constexpr Vector2f lerp( const Vector2f& v0, const Vector2f& v1, float alpha );
+
+private:
+
+	float m_elements[2];
+
+};
+
+// component-wise operators
+constexpr Vector2f operator + ( const Vector2f& v0, const Vector2f& v1 );
+constexpr Vector2f operator - ( const Vector2f& v0, const Vector2f& v1 );
+constexpr Vector2f operator * ( const Vector2f& v0, const Vector2f& v1 );
+constexpr Vector2f operator / ( const Vector2f& v0, const Vector2f& v1 );
+
+// unary negation
+constexpr Vector2f operator - ( const Vector2f& v );
+
+// multiply and divide by scalar
+constexpr Vector2f operator * ( float f, const Vector2f& v );
+constexpr Vector2f operator * ( const Vector2f& v, float f );
+constexpr Vector2f operator / ( const Vector2f& v, float f );
+
+constexpr bool operator == ( const Vector2f& v0, const Vector2f& v1 );
+constexpr bool operator != ( const Vector2f& v0, const Vector2f& v1 );
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Vector3f.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Public
+//////////////////////////////////////////////////////////////////////////
+
+// static
+inline const Vector2f Vector2f::ZERO = Vector2f( 0, 0 );
+
+// static
+inline const Vector2f Vector2f::UP = Vector2f( 0, 1 );
+
+// static
+inline const Vector2f Vector2f::RIGHT = Vector2f( 1, 0 );
+
+constexpr Vector2f::Vector2f( float f )
+	: m_elements{ f, f }
+{
+}
+
+constexpr Vector2f::Vector2f( float x, float y )
+	: m_elements{ x, y }
+{
+}
+
+constexpr const float& Vector2f::operator [] ( int i ) const
+{
+    return m_elements[i];
+}
+
+constexpr float& Vector2f::operator [] ( int i )
+{
+    return m_elements[i];
+}
+
+constexpr float& Vector2f::x()
+{
+    return m_elements[0];
+}
+
+constexpr float& Vector2f::y()
+{
+    return m_elements[1];
+}
+
+constexpr float Vector2f::x() const
+{
+    return m_elements[0];
+}
+
+constexpr float Vector2f::y() const
+{
+    return m_elements[1];
+}
+
+constexpr Vector2f Vector2f::xy() const
+{
+    return *this;
+}
+
+constexpr Vector2f Vector2f::yx() const
+{
+    return Vector2f( m_elements[1], m_elements[0] );
+}
+
+constexpr Vector2f Vector2f::xx() const
+{
+    return Vector2f( m_elements[0], m_elements[0] );
+}
+
+constexpr Vector2f Vector2f::yy() const
+{
+    return Vector2f( m_elements[1], m_elements[1] );
+}
+
+constexpr Vector2f Vector2f::normal() const
+{
+    return Vector2f( -m_elements[1], m_elements[0] );
+}
+
+inline float Vector2f::abs() const
+{
+    return sqrt(absSquared());
+}
+
+inline float Vector2f::absSquared() const
+{
+    return m_elements[0] * m_elements[0] + m_elements[1] * m_elements[1];
+}
+
+inline void Vector2f::normalize()
+{
+    float norm = abs();
+    m_elements[0] /= norm;
+    m_elements[1] /= norm;
+}
+
+inline Vector2f Vector2f::normalized() const
+{
+    float norm = abs();
+    return Vector2f( m_elements[0] / norm, m_elements[1] / norm );
+}
+
+inline void Vector2f::negate()
+{
+    m_elements[0] = -m_elements[0];
+    m_elements[1] = -m_elements[1];
+}
+
+inline Vector2f::operator const float* () const
+{
+    return m_elements;
+}
+
+inline Vector2f::operator float* ()
+{
+    return m_elements;
+}
+
+inline void Vector2f::print() const
+{
+	printf( "< %.4f, %.4f >\n",
+		m_elements[0], m_elements[1] );
+}
+
+inline Vector2f& Vector2f::operator += ( const Vector2f& v )
+{
+	m_elements[ 0 ] += v.m_elements[ 0 ];
+	m_elements[ 1 ] += v.m_elements[ 1 ];
+	return *this;
+}
+
+inline Vector2f& Vector2f::operator -= ( const Vector2f& v )
+{
+	m_elements[ 0 ] -= v.m_elements[ 0 ];
+	m_elements[ 1 ] -= v.m_elements[ 1 ];
+	return *this;
+}
+
+inline Vector2f& Vector2f::operator *= ( float f )
+{
+	m_elements[ 0 ] *= f;
+	m_elements[ 1 ] *= f;
+	return *this;
+}
+
+// static
+constexpr float Vector2f::dot( const Vector2f& v0, const Vector2f& v1 )
+{
+    return v0[0] * v1[0] + v0[1] * v1[1];
+}
+
+// static
+constexpr Vector3f Vector2f::cross( const Vector2f& v0, const Vector2f& v1 )
+{
+	return Vector3f
+		(
+			0,
+			0,
+			v0.x() * v1.y() - v0.y() * v1.x()
+		);
+}
+
+// static
+constexpr Vector2f Vector2f::lerp( const Vector2f& v0, const Vector2f& v1, float alpha )
+{
+	return alpha * ( v1 - v0 ) + v0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Operator overloading
+//////////////////////////////////////////////////////////////////////////
+
+constexpr Vector2f operator + ( const Vector2f& v0, const Vector2f& v1 )
+{
+    return Vector2f( v0.x() + v1.x(), v0.y() + v1.y() );
+}
+
+constexpr Vector2f operator - ( const Vector2f& v0, const Vector2f& v1 )
+{
+    return Vector2f( v0.x() - v1.x(), v0.y() - v1.y() );
+}
+
+constexpr Vector2f operator * ( const Vector2f& v0, const Vector2f& v1 )
+{
+    return Vector2f( v0.x() * v1.x(), v0.y() * v1.y() );
+}
+
+constexpr Vector2f operator / ( const Vector2f& v0, const Vector2f& v1 )
+{
+    return Vector2f( v0.x() * v1.x(), v0.y() * v1.y() );
+}
+
+constexpr Vector2f operator - ( const Vector2f& v )
+{
+    return Vector2f( -v.x(), -v.y() );
+}
+
+constexpr Vector2f operator * ( float f, const Vector2f& v )
+{
+    return Vector2f( f * v.x(), f * v.y() );
+}
+
+constexpr Vector2f operator * ( const Vector2f& v, float f )
+{
+    return Vector2f( f * v.x(), f * v.y() );
+}
+
+constexpr Vector2f operator / ( const Vector2f& v, float f )
+{
+    return Vector2f( v.x() / f, v.y() / f );
+}
+
+constexpr bool operator == ( const Vector2f& v0, const Vector2f& v1 )
+{
+    return( v0.x() == v1.x() && v0.y() == v1.y() );
+}
+
+constexpr bool operator != ( const Vector2f& v0, const Vector2f& v1 )
+{
+    return !( v0 == v1 );
+}
+
+#endif // VECTOR_2F_H
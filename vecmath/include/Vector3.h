@@ -0,0 +1,291 @@
+#ifndef VECTOR_3_H
+#define VECTOR_3_H
+
+#include <cstddef>
+
+class Vector3f;
+
+// A 3-vector with components of type T.  Vector3f stays the vector
+// used everywhere; this is for the places that need another precision,
+// as Vector3d for long transform chains and Vector3h to store bulk
+// vertex arrays in half the space.  Conversions between precisions are
+// explicit so that none is lost by accident.
+//
+// Vector3h is storage only: Half has no arithmetic, so only the
+// constructors, element access and conversions can be used with it.
+template< typename T >
+class Vector3
+{
+public:
+
+	constexpr Vector3();
+	constexpr explicit Vector3( T f );
+	constexpr Vector3( T x, T y, T z );
+
+	// widening or narrowing from another precision
+	template< typename U >
+	constexpr explicit Vector3( const Vector3< U >& v );
+
+	explicit Vector3( const Vector3f& v );
+	explicit operator Vector3f() const;
+
+	// returns the ith element
+	constexpr const T& operator [] ( int i ) const;
+	constexpr T& operator [] ( int i );
+
+	constexpr T& x();
+	constexpr T& y();
+	constexpr T& z();
+
+	constexpr T x() const;
+	constexpr T y() const;
+	constexpr T z() const;
+
+	T abs() const;
+	constexpr T absSquared() const;
+	Vector3 normalized() const;
+
+	Vector3& operator += ( const Vector3& v );
+	Vector3& operator -= ( const Vector3& v );
+	Vector3& operator *= ( T f );
+
+	static constexpr T dot( const Vector3& v0, const Vector3& v1 );
+	static constexpr Vector3 cross( const Vector3& v0, const Vector3& v1 );
+
+private:
+
+	T m_elements[ 3 ];
+
+};
+
+class Half;
+
+typedef Vector3< double > Vector3d;
+typedef Vector3< Half > Vector3h;
+
+template< typename T >
+constexpr Vector3< T > operator + ( const Vector3< T >& v0, const Vector3< T >& v1 );
+template< typename T >
+constexpr Vector3< T > operator - ( const Vector3< T >& v0, const Vector3< T >& v1 );
+template< typename T >
+constexpr Vector3< T > operator - ( const Vector3< T >& v );
+template< typename T >
+constexpr Vector3< T > operator * ( T f, const Vector3< T >& v );
+template< typename T >
+constexpr Vector3< T > operator * ( const Vector3< T >& v, T f );
+template< typename T >
+constexpr Vector3< T > operator / ( const Vector3< T >& v, T f );
+
+// Converts count vectors between float and half precision.  Narrowing
+// rounds to the nearest half; widening is exact.
+void narrow( const Vector3f* input, Vector3h* output, size_t count );
+void widen( const Vector3h* input, Vector3f* output, size_t count );
+
+#include <cmath>
+
+#include "Half.h"
+#include "Vector3f.h"
+
+template< typename T >
+constexpr Vector3< T >::Vector3()
+	: m_elements{}
+{
+}
+
+template< typename T >
+constexpr Vector3< T >::Vector3( T f )
+	: m_elements{ f, f, f }
+{
+}
+
+template< typename T >
+constexpr Vector3< T >::Vector3( T x, T y, T z )
+	: m_elements{ x, y, z }
+{
+}
+
+template< typename T >
+template< typename U >
+constexpr Vector3< T >::Vector3( const Vector3< U >& v )
+	: m_elements{ static_cast< T >( v[0] ), static_cast< T >( v[1] ), static_cast< T >( v[2] ) }
+{
+}
+
+template< typename T >
+inline Vector3< T >::Vector3( const Vector3f& v )
+	: m_elements{ static_cast< T >( v[0] ), static_cast< T >( v[1] ), static_cast< T >( v[2] ) }
+{
+}
+
+template< typename T >
+inline Vector3< T >::operator Vector3f() const
+{
+	return Vector3f( static_cast< float >( m_elements[0] ), static_cast< float >( m_elements[1] ), static_cast< float >( m_elements[2] ) );
+}
+
+template< typename T >
+constexpr const T& Vector3< T >::operator [] ( int i ) const
+{
+	return m_elements[i];
+}
+
+template< typename T >
+constexpr T& Vector3< T >::operator [] ( int i )
+{
+	return m_elements[i];
+}
+
+template< typename T >
+constexpr T& Vector3< T >::x()
+{
+	return m_elements[0];
+}
+
+template< typename T >
+constexpr T& Vector3< T >::y()
+{
+	return m_elements[1];
+}
+
+template< typename T >
+constexpr T& Vector3< T >::z()
+{
+	return m_elements[2];
+}
+
+template< typename T >
+constexpr T Vector3< T >::x() const
+{
+	return m_elements[0];
+}
+
+template< typename T >
+constexpr T Vector3< T >::y() const
+{
+	return m_elements[1];
+}
+
+template< typename T >
+constexpr T Vector3< T >::z() const
+{
+	return m_elements[2];
+}
+
+template< typename T >
+inline T Vector3< T >::abs() const
+{
+	return std::sqrt( absSquared() );
+}
+
+template< typename T >
+constexpr T Vector3< T >::absSquared() const
+{
+	return m_elements[0] * m_elements[0] + m_elements[1] * m_elements[1] + m_elements[2] * m_elements[2];
+}
+
+template< typename T >
+inline Vector3< T > Vector3< T >::normalized() const
+{
+	T norm = abs();
+	return Vector3( m_elements[0] / norm, m_elements[1] / norm, m_elements[2] / norm );
+}
+
+template< typename T >
+inline Vector3< T >& Vector3< T >::operator += ( const Vector3& v )
+{
+	m_elements[0] += v.m_elements[0];
+	m_elements[1] += v.m_elements[1];
+	m_elements[2] += v.m_elements[2];
+	return *this;
+}
+
+template< typename T >
+inline Vector3< T >& Vector3< T >::operator -= ( const Vector3& v )
+{
+	m_elements[0] -= v.m_elements[0];
+	m_elements[1] -= v.m_elements[1];
+	m_elements[2] -= v.m_elements[2];
+	return *this;
+}
+
+template< typename T >
+inline Vector3< T >& Vector3< T >::operator *= ( T f )
+{
+	m_elements[0] *= f;
+	m_elements[1] *= f;
+	m_elements[2] *= f;
+	return *this;
+}
+
+// static
+template< typename T >
+constexpr T Vector3< T >::dot( const Vector3& v0, const Vector3& v1 )
+{
+	return v0[0] * v1[0] + v0[1] * v1[1] + v0[2] * v1[2];
+}
+
+// static
+template< typename T >
+constexpr Vector3< T > Vector3< T >::cross( const Vector3& v0, const Vector3& v1 )
+{
+	return Vector3
+		(
+			v0.y() * v1.z() - v0.z() * v1.y(),
+			v0.z() * v1.x() - v0.x() * v1.z(),
+			v0.x() * v1.y() - v0.y() * v1.x()
+		);
+}
+
+template< typename T >
+constexpr Vector3< T > operator + ( const Vector3< T >& v0, const Vector3< T >& v1 )
+{
+	return Vector3< T >( v0[0] + v1[0], v0[1] + v1[1], v0[2] + v1[2] );
+}
+
+template< typename T >
+constexpr Vector3< T > operator - ( const Vector3< T >& v0, const Vector3< T >& v1 )
+{
+	return Vector3< T >( v0[0] - v1[0], v0[1] - v1[1], v0[2] - v1[2] );
+}
+
+template< typename T >
+constexpr Vector3< T > operator - ( const Vector3< T >& v )
+{
+	return Vector3< T >( -v[0], -v[1], -v[2] );
+}
+
+template< typename T >
+constexpr Vector3< T > operator * ( T f, const Vector3< T >& v )
+{
+	return Vector3< T >( v[0] * f, v[1] * f, v[2] * f );
+}
+
+template< typename T >
+constexpr Vector3< T > operator * ( const Vector3< T >& v, T f )
+{
+	return Vector3< T >( v[0] * f, v[1] * f, v[2] * f );
+}
+
+template< typename T >
+constexpr Vector3< T > operator / ( const Vector3< T >& v, T f )
+{
+	return Vector3< T >( v[0] / f, v[1] / f, v[2] / f );
+}
+
+inline void narrow( const Vector3f* input, Vector3h* output, size_t count )
+{
+	for( size_t i = 0; i < count; ++i )
+	{
+		output[ i ] = Vector3h( input[ i ] );
+	}
+}
+
+inline void widen( const Vector3h* input, Vector3f* output, size_t count )
+{
+	for( size_t i = 0; i < count; ++i )
+	{
+		output[ i ] = static_cast< Vector3f >( input[ i ] );
+	}
+}
+
+#endif // VECTOR_3_H
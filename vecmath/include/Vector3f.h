@@ -0,0 +1,399 @@
+#ifndef VECTOR_3F_H
+#define VECTOR_3F_H
+
+class Vector2f;
+
+class Vector3f
+{
+public:
+
+	static const Vector3f ZERO;
+	static const Vector3f UP;
+	static const Vector3f RIGHT;
+	static const Vector3f FORWARD;
+
+    constexpr Vector3f( float f = 0.f );
+    constexpr Vector3f( float x, float y, float z );
+
+	constexpr Vector3f( const Vector2f& xy, float z );
+	constexpr Vector3f( float x, const Vector2f& yz );
+
+	// copy constructors
+    Vector3f( const Vector3f& rv ) = default;
+
+	// assignment operators
+    Vector3f& operator = ( const Vector3f& rv ) = default;
+
+	// no destructor necessary
+
+	// returns the ith element
+    constexpr const float& operator [] ( int i ) const;
+    constexpr float& operator [] ( int i );
+
+    constexpr float& x();
+	constexpr float& y();
+	constexpr float& z();
+
+	constexpr float x() const;
+	constexpr float y() const;
+	constexpr float z() const;
+
+	constexpr Vector2f xy() const;
+	constexpr Vector2f xz() const;
+	constexpr Vector2f yz() const;
+
+	constexpr Vector3f xyz() const;
+	constexpr Vector3f yzx() const;
+	constexpr Vector3f zxy() const;
+
+	float abs() const;
+    float absSquared() const;
+
+	void normalize();
+	Vector3f normalized() const;
+
+	Vector2f homogenized() const;
+
+	void negate();
+
+	// ---- Utility ----
+    operator const float* () const; // automatic type conversion for OpenGL
+    operator float* (); // automatic type conversion for OpenGL 
+	void print() const;	
+
+	Vector3f& operator += ( const Vector3f& v );
+	Vector3f& operator -= ( const Vector3f& v );
+    Vector3f& operator *= ( float f );
+
+    static constexpr float dot( const Vector3f& v0, const Vector3f& v1 );
+	static constexpr Vector3f cross( const Vector3f& v0, const Vector3f& v1 );
+    
+    // computes the linear interpolation between v0 and v1 by alpha \in [0,1]
+	// returns v0 * ( 1 - alpha ) * v1 * alpha
+	static constexpr Vector3f lerp( const Vector3f& v0, const Vector3f& v1, float alpha );
+
+	// computes the cubic catmull-rom interpolation between p0, p1, p2, p3
+    // by t \in [0,1].  Guarantees that at t = 0, the result is p0 and
+    // at p1, the result is p2.
+	static Vector3f cubicInterpolate( const Vector3f& p0, const Vector3f& p1, const Vector3f& p2, const Vector3f& p3, float t );
+
+private:
+
+	float m_elements[ 3 ];
+
+};
+
+// component-wise operators
+constexpr Vector3f operator + ( const Vector3f& v0, const Vector3f& v1 );
+constexpr Vector3f operator - ( const Vector3f& v0, const Vector3f& v1 );
+constexpr Vector3f operator * ( const Vector3f& v0, const Vector3f& v1 );
+constexpr Vector3f operator / ( const Vector3f& v0, const Vector3f& v1 );
+
+// unary negation
+constexpr Vector3f operator - ( const Vector3f& v );
+
+// multiply and divide by scalar
+constexpr Vector3f operator * ( float f, const Vector3f& v );
+constexpr Vector3f operator * ( const Vector3f& v, float f );
+constexpr Vector3f operator / ( const Vector3f& v, float f );
+
+constexpr bool operator == ( const Vector3f& v0, const Vector3f& v1 );
+constexpr bool operator != ( const Vector3f& v0, const Vector3f& v1 );
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Vector2f.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Public
+//////////////////////////////////////////////////////////////////////////
+
+// static
+inline const Vector3f Vector3f::ZERO = Vector3f( 0, 0, 0 );
+
+// static
+inline const Vector3f Vector3f::UP = Vector3f( 0, 1, 0 );
+
+// static
+inline const Vector3f Vector3f::RIGHT = Vector3f( 1, 0, 0 );
+
+// static
+inline const Vector3f Vector3f::FORWARD = Vector3f( 0, 0, -1 );
+
+constexpr Vector3f::Vector3f( float f )
+	: m_elements{ f, f, f }
+{
+}
+
+constexpr Vector3f::Vector3f( float x, float y, float z )
+	: m_elements{ x, y, z }
+{
+}
+
+constexpr Vector3f::Vector3f( const Vector2f& xy, float z )
+	: m_elements{ xy.x(), xy.y(), z }
+{
+}
+
+constexpr Vector3f::Vector3f( float x, const Vector2f& yz )
+	: m_elements{ x, yz.x(), yz.y() }
+{
+}
+
+constexpr const float& Vector3f::operator [] ( int i ) const
+{
+    return m_elements[i];
+}
+
+constexpr float& Vector3f::operator [] ( int i )
+{
+    return m_elements[i];
+}
+
+constexpr float& Vector3f::x()
+{
+    return m_elements[0];
+}
+
+constexpr float& Vector3f::y()
+{
+    return m_elements[1];
+}
+
+constexpr float& Vector3f::z()
+{
+    return m_elements[2];
+}
+
+constexpr float Vector3f::x() const
+{
+    return m_elements[0];
+}
+
+constexpr float Vector3f::y() const
+{
+    return m_elements[1];
+}
+
+constexpr float Vector3f::z() const
+{
+    return m_elements[2];
+}
+
+constexpr Vector2f Vector3f::xy() const
+{
+	return Vector2f( m_elements[0], m_elements[1] );
+}
+
+constexpr Vector2f Vector3f::xz() const
+{
+	return Vector2f( m_elements[0], m_elements[2] );
+}
+
+constexpr Vector2f Vector3f::yz() const
+{
+	return Vector2f( m_elements[1], m_elements[2] );
+}
+
+constexpr Vector3f Vector3f::xyz() const
+{
+	return Vector3f( m_elements[0], m_elements[1], m_elements[2] );
+}
+
+constexpr Vector3f Vector3f::yzx() const
+{
+	return Vector3f( m_elements[1], m_elements[2], m_elements[0] );
+}
+
+constexpr Vector3f Vector3f::zxy() const
+{
+	return Vector3f( m_elements[2], m_elements[0], m_elements[1] );
+}
+
+inline float Vector3f::abs() const
+{
+	return sqrt( m_elements[0] * m_elements[0] + m_elements[1] * m_elements[1] + m_elements[2] * m_elements[2] );
+}
+
+inline float Vector3f::absSquared() const
+{
+    return
+        (
+            m_elements[0] * m_elements[0] +
+            m_elements[1] * m_elements[1] +
+            m_elements[2] * m_elements[2]
+        );
+}
+
+inline void Vector3f::normalize()
+{
+	float norm = abs();
+	m_elements[0] /= norm;
+	m_elements[1] /= norm;
+	m_elements[2] /= norm;
+}
+
+inline Vector3f Vector3f::normalized() const
+{
+	float norm = abs();
+	return Vector3f
+		(
+			m_elements[0] / norm,
+			m_elements[1] / norm,
+			m_elements[2] / norm
+		);
+}
+
+inline Vector2f Vector3f::homogenized() const
+{
+	return Vector2f
+		(
+			m_elements[ 0 ] / m_elements[ 2 ],
+			m_elements[ 1 ] / m_elements[ 2 ]
+		);
+}
+
+inline void Vector3f::negate()
+{
+	m_elements[0] = -m_elements[0];
+	m_elements[1] = -m_elements[1];
+	m_elements[2] = -m_elements[2];
+}
+
+inline Vector3f::operator const float* () const
+{
+    return m_elements;
+}
+
+inline Vector3f::operator float* ()
+{
+    return m_elements;
+}
+
+inline void Vector3f::print() const
+{
+	printf( "< %.4f, %.4f, %.4f >\n",
+		m_elements[0], m_elements[1], m_elements[2] );
+}
+
+inline Vector3f& Vector3f::operator += ( const Vector3f& v )
+{
+	m_elements[ 0 ] += v.m_elements[ 0 ];
+	m_elements[ 1 ] += v.m_elements[ 1 ];
+	m_elements[ 2 ] += v.m_elements[ 2 ];
+	return *this;
+}
+
+inline Vector3f& Vector3f::operator -= ( const Vector3f& v )
+{
+	m_elements[ 0 ] -= v.m_elements[ 0 ];
+	m_elements[ 1 ] -= v.m_elements[ 1 ];
+	m_elements[ 2 ] -= v.m_elements[ 2 ];
+	return *this;
+}
+
+inline Vector3f& Vector3f::operator *= ( float f )
+{
+	m_elements[ 0 ] *= f;
+	m_elements[ 1 ] *= f;
+	m_elements[ 2 ] *= f;
+	return *this;
+}
+
+// static
+constexpr float Vector3f::dot( const Vector3f& v0, const Vector3f& v1 )
+{
+    return v0[0] * v1[0] + v0[1] * v1[1] + v0[2] * v1[2];
+}
+
+// static
+constexpr Vector3f Vector3f::cross( const Vector3f& v0, const Vector3f& v1 )
+{
+    return Vector3f
+        (
+            v0.y() * v1.z() - v0.z() * v1.y(),
+            v0.z() * v1.x() - v0.x() * v1.z(),
+            v0.x() * v1.y() - v0.y() * v1.x()
+        );
+}
+
+// static
+constexpr Vector3f Vector3f::lerp( const Vector3f& v0, const Vector3f& v1, float alpha )
+{
+	return alpha * ( v1 - v0 ) + v0;
+}
+
+// static
+inline Vector3f Vector3f::cubicInterpolate( const Vector3f& p0, const Vector3f& p1, const Vector3f& p2, const Vector3f& p3, float t )
+{
+	// geometric construction:
+	//            t
+	//   (t+1)/2     t/2
+	// t+1        t	        t-1
+
+	// bottom level
+	Vector3f p0p1 = Vector3f::lerp( p0, p1, t + 1 );
+	Vector3f p1p2 = Vector3f::lerp( p1, p2, t );
+	Vector3f p2p3 = Vector3f::lerp( p2, p3, t - 1 );
+
+	// middle level
+	Vector3f p0p1_p1p2 = Vector3f::lerp( p0p1, p1p2, 0.5f * ( t + 1 ) );
+	Vector3f p1p2_p2p3 = Vector3f::lerp( p1p2, p2p3, 0.5f * t );
+
+	// top level
+	return Vector3f::lerp( p0p1_p1p2, p1p2_p2p3, t );
+}
+
+constexpr Vector3f operator + ( const Vector3f& v0, const Vector3f& v1 )
+{
+    return Vector3f( v0[0] + v1[0], v0[1] + v1[1], v0[2] + v1[2] );
+}
+
+constexpr Vector3f operator - ( const Vector3f& v0, const Vector3f& v1 )
+{
+    return Vector3f( v0[0] - v1[0], v0[1] - v1[1], v0[2] - v1[2] );
+}
+
+constexpr Vector3f operator * ( const Vector3f& v0, const Vector3f& v1 )
+{
+    return Vector3f( v0[0] * v1[0], v0[1] * v1[1], v0[2] * v1[2] );
+}
+
+constexpr Vector3f operator / ( const Vector3f& v0, const Vector3f& v1 )
+{
+    return Vector3f( v0[0] / v1[0], v0[1] / v1[1], v0[2] / v1[2] );
+}
+
+constexpr Vector3f operator - ( const Vector3f& v )
+{
+    return Vector3f( -v[0], -v[1], -v[2] );
+}
+
+constexpr Vector3f operator * ( float f, const Vector3f& v )
+{
+    return Vector3f( v[0] * f, v[1] * f, v[2] * f );
+}
+
+constexpr Vector3f operator * ( const Vector3f& v, float f )
+{
+    return Vector3f( v[0] * f, v[1] * f, v[2] * f );
+}
+
+constexpr Vector3f operator / ( const Vector3f& v, float f )
+{
+    return Vector3f( v[0] / f, v[1] / f, v[2] / f );
+}
+
+constexpr bool operator == ( const Vector3f& v0, const Vector3f& v1 )
+{
+    return( v0.x() == v1.x() && v0.y() == v1.y() && v0.z() == v1.z() );
+}
+
+constexpr bool operator != ( const Vector3f& v0, const Vector3f& v1 )
+{
+    return !( v0 == v1 );
+}
+
+#endif // VECTOR_3F_H
@@ -0,0 +1,270 @@
+#ifndef VECTOR_EXPRESSION_H
+#define VECTOR_EXPRESSION_H
+
+// Expression templates for component-wise Vector2f, Vector3f and
+// Vector4f arithmetic.  This is opt in: the operators of the vector
+// classes are unchanged, and an expression only becomes lazy once one
+// of its operands is wrapped in lazy():
+//
+//   V = lazy( P[0] ) * w[0] + lazy( P[1] ) * w[1] + lazy( P[2] ) * w[2];
+//
+// builds a tree of references instead of a vector per operator, and
+// evaluates it one component at a time when it is assigned (or
+// otherwise converted) to a vector.  The operations are done in the
+// same order as with the plain operators, so the results are the same
+// bit for bit.
+//
+// An expression refers to its operands, so it has to be evaluated in
+// the statement that builds it: don't keep one in an auto variable.
+// Only component-wise operations are lazy; cross products, norms and
+// matrix products take and return plain vectors as before.
+
+#include "Vector2f.h"
+#include "Vector3f.h"
+#include "Vector4f.h"
+
+namespace vecexpr
+{
+	template< typename V > struct VectorSize;
+	template<> struct VectorSize< Vector2f > { static constexpr int value = 2; };
+	template<> struct VectorSize< Vector3f > { static constexpr int value = 3; };
+	template<> struct VectorSize< Vector4f > { static constexpr int value = 4; };
+
+	// The base of every node, E being the node itself and V the vector
+	// type it evaluates to.  Nodes implement at( i ), the ith component.
+	template< typename E, typename V >
+	struct Expression
+	{
+		constexpr const E& self() const
+		{
+			return static_cast< const E& >( *this );
+		}
+
+		// Spelled out per size rather than looped: at -O2 the loop is not
+		// always unrolled, and then every node is visited through an index.
+		constexpr V evaluate() const
+		{
+			const E& e = self();
+			if constexpr( VectorSize< V >::value == 2 )
+			{
+				return V( e.at( 0 ), e.at( 1 ) );
+			}
+			else if constexpr( VectorSize< V >::value == 3 )
+			{
+				return V( e.at( 0 ), e.at( 1 ), e.at( 2 ) );
+			}
+			else
+			{
+				return V( e.at( 0 ), e.at( 1 ), e.at( 2 ), e.at( 3 ) );
+			}
+		}
+
+		constexpr operator V() const
+		{
+			return evaluate();
+		}
+	};
+
+	// a vector as a leaf of the tree
+	template< typename V >
+	struct Ref : Expression< Ref< V >, V >
+	{
+		constexpr explicit Ref( const V& v ) : v( v ) { }
+		constexpr float at( int i ) const { return v[ i ]; }
+
+		const V& v;
+	};
+
+	template< typename L, typename R, typename V >
+	struct Sum : Expression< Sum< L, R, V >, V >
+	{
+		constexpr Sum( const L& l, const R& r ) : l( l ), r( r ) { }
+		constexpr float at( int i ) const { return l.at( i ) + r.at( i ); }
+
+		L l;
+		R r;
+	};
+
+	template< typename L, typename R, typename V >
+	struct Difference : Expression< Difference< L, R, V >, V >
+	{
+		constexpr Difference( const L& l, const R& r ) : l( l ), r( r ) { }
+		constexpr float at( int i ) const { return l.at( i ) - r.at( i ); }
+
+		L l;
+		R r;
+	};
+
+	// component-wise product
+	template< typename L, typename R, typename V >
+	struct Product : Expression< Product< L, R, V >, V >
+	{
+		constexpr Product( const L& l, const R& r ) : l( l ), r( r ) { }
+		constexpr float at( int i ) const { return l.at( i ) * r.at( i ); }
+
+		L l;
+		R r;
+	};
+
+	template< typename E, typename V >
+	struct Scaled : Expression< Scaled< E, V >, V >
+	{
+		constexpr Scaled( const E& e, float f ) : e( e ), f( f ) { }
+		constexpr float at( int i ) const { return e.at( i ) * f; }
+
+		E e;
+		float f;
+	};
+
+	template< typename E, typename V >
+	struct Quotient : Expression< Quotient< E, V >, V >
+	{
+		constexpr Quotient( const E& e, float f ) : e( e ), f( f ) { }
+		constexpr float at( int i ) const { return e.at( i ) / f; }
+
+		E e;
+		float f;
+	};
+
+	template< typename E, typename V >
+	struct Negated : Expression< Negated< E, V >, V >
+	{
+		constexpr explicit Negated( const E& e ) : e( e ) { }
+		constexpr float at( int i ) const { return -e.at( i ); }
+
+		E e;
+	};
+
+	// starts a lazy expression
+	template< typename V >
+	constexpr Ref< V > lazy( const V& v )
+	{
+		return Ref< V >( v );
+	}
+
+	// An operand that is a plain vector becomes a leaf.
+	template< typename E, typename V >
+	constexpr const E& node( const Expression< E, V >& e )
+	{
+		return e.self();
+	}
+
+	constexpr Ref< Vector2f > node( const Vector2f& v ) { return Ref< Vector2f >( v ); }
+	constexpr Ref< Vector3f > node( const Vector3f& v ) { return Ref< Vector3f >( v ); }
+	constexpr Ref< Vector4f > node( const Vector4f& v ) { return Ref< Vector4f >( v ); }
+
+	template< typename L, typename R, typename V >
+	constexpr Sum< L, R, V > operator + ( const Expression< L, V >& l, const Expression< R, V >& r )
+	{
+		return Sum< L, R, V >( l.self(), r.self() );
+	}
+
+	template< typename L, typename V >
+	constexpr Sum< L, Ref< V >, V > operator + ( const Expression< L, V >& l, const V& r )
+	{
+		return Sum< L, Ref< V >, V >( l.self(), node( r ) );
+	}
+
+	template< typename R, typename V >
+	constexpr Sum< Ref< V >, R, V > operator + ( const V& l, const Expression< R, V >& r )
+	{
+		return Sum< Ref< V >, R, V >( node( l ), r.self() );
+	}
+
+	template< typename L, typename R, typename V >
+	constexpr Difference< L, R, V > operator - ( const Expression< L, V >& l, const Expression< R, V >& r )
+	{
+		return Difference< L, R, V >( l.self(), r.self() );
+	}
+
+	template< typename L, typename V >
+	constexpr Difference< L, Ref< V >, V > operator - ( const Expression< L, V >& l, const V& r )
+	{
+		return Difference< L, Ref< V >, V >( l.self(), node( r ) );
+	}
+
+	template< typename R, typename V >
+	constexpr Difference< Ref< V >, R, V > operator - ( const V& l, const Expression< R, V >& r )
+	{
+		return Difference< Ref< V >, R, V >( node( l ), r.self() );
+	}
+
+	template< typename L, typename R, typename V >
+	constexpr Product< L, R, V > operator * ( const Expression< L, V >& l, const Expression< R, V >& r )
+	{
+		return Product< L, R, V >( l.self(), r.self() );
+	}
+
+	template< typename E, typename V >
+	constexpr Scaled< E, V > operator * ( const Expression< E, V >& e, float f )
+	{
+		return Scaled< E, V >( e.self(), f );
+	}
+
+	template< typename E, typename V >
+	constexpr Scaled< E, V > operator * ( float f, const Expression< E, V >& e )
+	{
+		return Scaled< E, V >( e.self(), f );
+	}
+
+	template< typename E, typename V >
+	constexpr Quotient< E, V > operator / ( const Expression< E, V >& e, float f )
+	{
+		return Quotient< E, V >( e.self(), f );
+	}
+
+	template< typename E, typename V >
+	constexpr Negated< E, V > operator - ( const Expression< E, V >& e )
+	{
+		return Negated< E, V >( e.self() );
+	}
+
+	// Compound assignment, also one component at a time.  Every node is
+	// component-wise, so v may appear in the expression.
+	template< typename E, typename V >
+	inline V& operator += ( V& v, const Expression< E, V >& e )
+	{
+		const E& x = e.self();
+		v[ 0 ] += x.at( 0 );
+		v[ 1 ] += x.at( 1 );
+		if constexpr( VectorSize< V >::value > 2 )
+		{
+			v[ 2 ] += x.at( 2 );
+		}
+		if constexpr( VectorSize< V >::value > 3 )
+		{
+			v[ 3 ] += x.at( 3 );
+		}
+		return v;
+	}
+
+	template< typename E, typename V >
+	inline V& operator -= ( V& v, const Expression< E, V >& e )
+	{
+		const E& x = e.self();
+		v[ 0 ] -= x.at( 0 );
+		v[ 1 ] -= x.at( 1 );
+		if constexpr( VectorSize< V >::value > 2 )
+		{
+			v[ 2 ] -= x.at( 2 );
+		}
+		if constexpr( VectorSize< V >::value > 3 )
+		{
+			v[ 3 ] -= x.at( 3 );
+		}
+		return v;
+	}
+
+	template< typename L, typename R, typename V >
+	constexpr float dot( const Expression< L, V >& l, const Expression< R, V >& r )
+	{
+		float sum = l.self().at( 0 ) * r.self().at( 0 );
+		for( int i = 1; i < VectorSize< V >::value; ++i )
+		{
+			sum += l.self().at( i ) * r.self().at( i );
+		}
+		return sum;
+	}
+}
+
+#endif // VECTOR_EXPRESSION_H
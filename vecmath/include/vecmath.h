@@ -1,11 +1,16 @@
 #ifndef VECMATH_H
 #define VECMATH_H
 
+#include "Affine3f.h"
+#include "Half.h"
 #include "Matrix2f.h"
 #include "Matrix3f.h"
+#include "Matrix4.h"
 #include "Matrix4f.h"
+#include "Quat.h"
 #include "Quat4f.h"
 #include "Vector2f.h"
+#include "Vector3.h"
 #include "Vector3f.h"
 #include "Vector4f.h"
 
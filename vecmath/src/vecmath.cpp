@@ -0,0 +1,8 @@
+// vecmath is header-only: everything is inline or constexpr in
+// include/.  This is the one translation unit of the library project,
+// so that the headers are compiled, with the library's flags, even
+// when no app is being built.
+
+#include "vecmath.h"
+#include "Simd4f.h"
+#include "VectorExpression.h"
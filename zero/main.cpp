@@ -2,11 +2,14 @@
 #include <GLEW/glew.h>
 #include "GL/freeglut.h"
 #include <cmath>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <vector>
 #include "vecmath.h"
 #include "main.h"
+#include "ao.h"
 
 #include <map>
 
@@ -31,9 +34,13 @@ vector<vector<unsigned>> inputFaces;
 // converted input data to upload to GPU
 vector<Vertex> uniqueVertices;
 vector<unsigned int> indices;
+// baked ambient occlusion per unique vertex, 1 = unoccluded.  It only
+// darkens the colors (see uploadVertexColors), so it isn't part of Vertex.
+vector<float> vertexOcclusion;
 
 // GPU data
 GLuint vertexBufferObjectVerticesId;
+GLuint vertexBufferObjectColorsId; //diffuse color darkened by AO
 GLuint elementBufferObject; //indices
 
 //navigation
@@ -60,6 +67,8 @@ std::streamsize const MAX_BUFFER_SIZE = 256;
 
 bool IS_ROTATE = false;
 
+bool IS_AO = true;
+
 
 // These are convenience functions which allow us to call OpenGL 
 // methods on Vec3d objects
@@ -84,6 +93,10 @@ void keyboardFunc(unsigned char key, int x, int y)
 		break;
 	case 'c':
 		colorIndex = (colorIndex + 1) % 4;
+		uploadVertexColors();
+		break;
+	case 'o':
+		IS_AO = !IS_AO;
 		break;
 	case 'r':
 		IS_ROTATE = !IS_ROTATE;
@@ -192,14 +205,28 @@ void drawScene(void)
 
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectVerticesId);
 	glVertexPointer(3, GL_FLOAT, sizeof(Vertex), (void*)offsetof(Vertex, pos));
 	glNormalPointer(GL_FLOAT, sizeof(Vertex), (void*)offsetof(Vertex, norm));
+
+	// With AO on, the per-vertex colors replace the ambient and diffuse material color
+	if (IS_AO)
+	{
+		glEnable(GL_COLOR_MATERIAL);
+		glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectColorsId);
+		glColorPointer(4, GL_FLOAT, 0, nullptr);
+	}
+
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBufferObject);
 
 	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
 
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisable(GL_COLOR_MATERIAL);
 
 	// Dump the image to the screen.
 	glutSwapBuffers();
@@ -232,19 +259,19 @@ void reshapeFunc(int w, int h)
 	gluPerspective(50.0, 1.0, 1.0, 100.0);
 }
 
-void loadInput()
+void loadInput(istream& in)
 {
 	char buffer[MAX_BUFFER_SIZE];
 
 	while (true)
 	{
-		cin.getline(buffer, MAX_BUFFER_SIZE);
+		in.getline(buffer, MAX_BUFFER_SIZE);
 		stringstream ss(buffer);
 
 		string s;
 		ss >> s;
 		if (s == "\0") {
-			cin.getline(buffer, MAX_BUFFER_SIZE);
+			in.getline(buffer, MAX_BUFFER_SIZE);
 			stringstream ss(buffer);
 			ss >> s;
 			if (s == "\0")
@@ -330,12 +357,42 @@ void loadInput()
 	}
 }
 
+//Bakes AO for the unique vertices. When the mesh came from a file, the result is cached next to it.
+void bakeOcclusion(const string& cacheFile)
+{
+	vector<Vector3f> positions(uniqueVertices.size());
+	vector<Vector3f> normals(uniqueVertices.size());
+	for (size_t i = 0; i < uniqueVertices.size(); ++i) {
+		positions[i] = Vector3f(uniqueVertices[i].pos[0], uniqueVertices[i].pos[1], uniqueVertices[i].pos[2]);
+		normals[i] = Vector3f(uniqueVertices[i].norm[0], uniqueVertices[i].norm[1], uniqueVertices[i].norm[2]);
+	}
+
+	bakeAmbientOcclusionCached(cacheFile, positions, normals, indices, vertexOcclusion);
+}
+
+void uploadVertexColors()
+{
+	vector<GLfloat> colors(4 * uniqueVertices.size());
+	for (size_t i = 0; i < uniqueVertices.size(); ++i) {
+		for (int c = 0; c < 3; ++c)
+			colors[4 * i + c] = diffColors[colorIndex][c] * vertexOcclusion[i];
+		colors[4 * i + 3] = diffColors[colorIndex][3];
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectColorsId);
+	glBufferData(GL_ARRAY_BUFFER,
+		colors.size() * sizeof(GLfloat),
+		colors.data(),
+		GL_STATIC_DRAW);
+}
+
 void uploadInputToGpu()
 {
 	//you can use VBOs in your program, without writing shaders, as long as your OpenGL context supports the compatibility profile
 	//The Compatibility Profile keeps all of the legacy (fixed-function) OpenGL functionality plus the modern programmable features.
 
 	glGenBuffers(1, &vertexBufferObjectVerticesId);
+	glGenBuffers(1, &vertexBufferObjectColorsId);
 	glGenBuffers(1, &elementBufferObject);
 
 	// Upload vertices
@@ -351,6 +408,8 @@ void uploadInputToGpu()
 		indices.size() * sizeof(GLuint),
 		indices.data(),
 		GL_STATIC_DRAW);
+
+	uploadVertexColors();
 }
 
 void time_rotate(int value) {
@@ -372,7 +431,22 @@ void time_rotate(int value) {
 // Set up OpenGL, define the callbacks and start the main loop
 int main(int argc, char** argv)
 {
-	loadInput();
+	// The mesh is read from the file given as the first argument, or from standard input
+	string cacheFile;
+	if (argc > 1) {
+		ifstream in(argv[1]);
+		if (!in) {
+			cerr << argv[1] << " not found" << endl;
+			return -1;
+		}
+		loadInput(in);
+		cacheFile = string(argv[1]) + ".ao";
+	}
+	else {
+		loadInput(cin);
+	}
+
+	bakeOcclusion(cacheFile);
 
 	glutInit(&argc, argv);
 